@@ -0,0 +1,175 @@
+; buffered stdin/stdout shared by the long number programs, one syscall per 64 KiB
+
+                section         .text
+
+                global          read_char
+                global          write_char
+                global          print_string
+                global          flush
+                global          exit
+                global          exit_status
+
+buf_size:       equ             64 * 1024
+
+; read one char from stdin
+; result:
+;    rax == -1 if error occurs or input is over
+;    rax \in [0; 255] if OK
+read_char:
+                push            rsi
+
+                mov             rsi, [in_pos]
+                cmp             rsi, [in_len]
+                jb              .ready
+                call            refill
+                cmp             rax, 0
+                jle             .error
+                xor             rsi, rsi
+
+.ready:
+                movzx           rax, byte [in_buf + rsi]
+                inc             rsi
+                mov             [in_pos], rsi
+
+                pop             rsi
+                ret
+.error:
+                mov             rax, -1
+                pop             rsi
+                ret
+
+; reads the next block of stdin into the input buffer
+; result:
+;    rax -- number of bytes read, <= 0 on end of input or error
+refill:
+                push            rdi
+                push            rsi
+                push            rdx
+                push            rcx
+                push            r11
+
+                xor             rax, rax
+                xor             rdi, rdi
+                mov             rsi, in_buf
+                mov             rdx, buf_size
+                syscall
+
+                xor             rdx, rdx
+                cmp             rax, 0
+                cmovg           rdx, rax
+                mov             [in_len], rdx
+                mov             qword [in_pos], 0
+
+                pop             r11
+                pop             rcx
+                pop             rdx
+                pop             rsi
+                pop             rdi
+                ret
+
+; write one char to stdout, errors are ignored
+;    al -- char
+write_char:
+                push            rdi
+
+                mov             rdi, [out_len]
+                cmp             rdi, buf_size
+                jb              .ready
+                call            flush
+                xor             rdi, rdi
+
+.ready:
+                mov             [out_buf + rdi], al
+                inc             rdi
+                mov             [out_len], rdi
+
+                pop             rdi
+                ret
+
+; print string to stdout
+;    rsi -- string
+;    rdx -- size
+print_string:
+                push            rcx
+                push            rsi
+                push            rdi
+                push            rdx
+
+.loop:
+                test            rdx, rdx
+                jz              .done
+                mov             rcx, buf_size
+                sub             rcx, [out_len]
+                jnz             .copy
+                call            flush
+                mov             rcx, buf_size
+
+.copy:
+                cmp             rcx, rdx
+                jbe             .fits
+                mov             rcx, rdx
+.fits:
+                mov             rdi, out_buf
+                add             rdi, [out_len]
+                add             [out_len], rcx
+                sub             rdx, rcx
+                rep movsb
+                jmp             .loop
+
+.done:
+                pop             rdx
+                pop             rdi
+                pop             rsi
+                pop             rcx
+                ret
+
+; writes the output buffer to stdout, errors are ignored
+flush:
+                push            rax
+                push            rdi
+                push            rsi
+                push            rdx
+                push            rcx
+                push            r11
+
+                mov             rsi, out_buf
+                mov             rdx, [out_len]
+.loop:
+                test            rdx, rdx
+                jz              .done
+                mov             rax, 1
+                mov             rdi, 1
+                syscall
+                cmp             rax, 0
+                jle             .done
+                add             rsi, rax
+                sub             rdx, rax
+                jmp             .loop
+
+.done:
+                mov             qword [out_len], 0
+                pop             r11
+                pop             rcx
+                pop             rdx
+                pop             rsi
+                pop             rdi
+                pop             rax
+                ret
+
+exit:
+                xor             rdi, rdi
+
+; flushes stdout and exits
+;    rdi -- exit status
+exit_status:
+                call            flush
+                mov             rax, 60
+                syscall
+
+
+                section         .bss
+in_pos:         resq            1
+in_len:         resq            1
+out_len:        resq            1
+in_buf:         resb            buf_size
+out_buf:        resb            buf_size
@@ -1,17 +1,37 @@
                 section         .text
 
                 global          _start
+                extern          read_char
+                extern          write_char
+                extern          print_string
+                extern          exit
+                extern          exit_status
 _start:
-                sub             rsp, 2 * 128 * 8
-                lea             rdi, [rsp + 128 * 8]
-                mov             rcx, 128
-                call            read_long
+                call            heap_init
 
-                mov             rdi, rsp
                 call            read_long
+                mov             rsi, rdi
+                mov             rdx, rcx
+                call            read_long
+                xchg            rdi, rsi
+                xchg            rcx, rdx
+
+                call            compare_long_long
+                jae             .ordered
+                xchg            rdi, rsi
+                xchg            rcx, rdx
 
-                lea             rsi, [rsp]
-                lea             rdi, [rsp + 128 * 8]
+                push            rdi
+                push            rsi
+                push            rcx
+                push            rdx
+                mov             al, '-'
+                call            write_char
+                pop             rdx
+                pop             rcx
+                pop             rsi
+                pop             rdi
+.ordered:
                 call            sub_long_long
 
                 call            write_long
@@ -21,55 +41,95 @@ _start:
 
                 jmp             exit
 
+; compares two long numbers
+;    rdi -- address of argument #1 (normalized long number)
+;    rcx -- length of argument #1 in qwords
+;    rsi -- address of argument #2 (normalized long number)
+;    rdx -- length of argument #2 in qwords
+; result:
+;    flags as after cmp of argument #1 with argument #2 (unsigned)
+compare_long_long:
+                cmp             rcx, rdx
+                jne             .done
+                push            rax
+                push            rcx
+
+.loop:
+                mov             rax, [rdi + 8 * rcx - 8]
+                cmp             rax, [rsi + 8 * rcx - 8]
+                jne             .pop
+                dec             rcx
+                jnz             .loop
+
+.pop:
+                pop             rcx
+                pop             rax
+.done:
+                ret
+
 ; sub two long number
 ;    rdi -- address of argument #1 (long number)
-;    rsi -- address of argument #2 (long number)
-;    rcx -- length of long numbers in qwords
+;    rcx -- length of argument #1 in qwords
+;    rsi -- address of argument #2 (long number), not greater than argument #1
+;    rdx -- length of argument #2 in qwords
 ; result:
 ;    sub is written to rdi
+;    rcx -- length of the difference in qwords
 sub_long_long:
                 push            rdi
                 push            rsi
-                push            rcx
+                push            rdx
 
                 clc
 .loop:
                 mov             rax, [rsi]
-
                 lea             rsi, [rsi + 8]
                 sbb             [rdi], rax
                 lea             rdi, [rdi + 8]
-                dec             rcx
+                dec             rdx
                 jnz             .loop
 
-                pop             rcx
+                jnc             .done
+.borrow:
+                sub             qword [rdi], 1
+                lea             rdi, [rdi + 8]
+                jc              .borrow
+
+.done:
+                pop             rdx
                 pop             rsi
                 pop             rdi
-                ret
+                jmp             normalize
 
 ; adds 64-bit number to long number
 ;    rdi -- address of summand #1 (long number)
 ;    rax -- summand #2 (64-bit unsigned)
 ;    rcx -- length of long number in qwords
+;    long number must have room for rcx + 1 qwords
 ; result:
 ;    sum is written to rdi
+;    rcx -- length of the sum in qwords
 add_long_short:
                 push            rdi
-                push            rcx
                 push            rdx
 
-                xor             rdx,rdx
-.loop:
+                mov             rdx, rcx
                 add             [rdi], rax
-                adc             rdx, 0
-                mov             rax, rdx
-                xor             rdx, rdx
+                jnc             .done
+.loop:
                 add             rdi, 8
-                dec             rcx
-                jnz             .loop
+                dec             rdx
+                jz              .grow
+                add             qword [rdi], 1
+                jc              .loop
+                jmp             .done
 
+.grow:
+                mov             qword [rdi], 1
+                inc             rcx
+
+.done:
                 pop             rdx
-                pop             rcx
                 pop             rdi
                 ret
 
@@ -77,13 +137,18 @@ add_long_short:
 ;    rdi -- address of multiplier #1 (long number)
 ;    rbx -- multiplier #2 (64-bit unsigned)
 ;    rcx -- length of long number in qwords
+;    long number must have room for rcx + 1 qwords
 ; result:
 ;    product is written to rdi
+;    rcx -- length of the product in qwords
 mul_long_short:
                 push            rax
+                push            rdx
                 push            rdi
-                push            rcx
+                push            rsi
+                push            r8
 
+                mov             r8, rcx
                 xor             rsi, rsi
 .loop:
                 mov             rax, [rdi]
@@ -93,11 +158,19 @@ mul_long_short:
                 mov             [rdi], rax
                 add             rdi, 8
                 mov             rsi, rdx
-                dec             rcx
+                dec             r8
                 jnz             .loop
 
-                pop             rcx
+                test            rsi, rsi
+                jz              .done
+                mov             [rdi], rsi
+                inc             rcx
+
+.done:
+                pop             r8
+                pop             rsi
                 pop             rdi
+                pop             rdx
                 pop             rax
                 ret
 
@@ -107,6 +180,7 @@ mul_long_short:
 ;    rcx -- length of long number in qwords
 ; result:
 ;    quotient is written to rdi
+;    rcx -- length of the quotient in qwords
 ;    rdx -- remainder
 div_long_short:
                 push            rdi
@@ -127,50 +201,106 @@ div_long_short:
                 pop             rcx
                 pop             rax
                 pop             rdi
-                ret
+                jmp             normalize
 
-; assigns a zero to long number
+; drops leading zero qwords of long number, zero keeps one qword
 ;    rdi -- argument (long number)
 ;    rcx -- length of long number in qwords
-set_zero:
-                push            rax
-                push            rdi
-                push            rcx
-
-                xor             rax, rax
-                rep stosq
-
-                pop             rcx
-                pop             rdi
-                pop             rax
+; result:
+;    rcx -- length without leading zeros
+normalize:
+                cmp             rcx, 1
+                je              .done
+                cmp             qword [rdi + 8 * rcx - 8], 0
+                jne             .done
+                dec             rcx
+                jmp             normalize
+.done:
                 ret
 
 ; checks if a long number is a zero
-;    rdi -- argument (long number)
+;    rdi -- argument (normalized long number)
 ;    rcx -- length of long number in qwords
 ; result:
 ;    ZF=1 if zero
 is_zero:
-                push            rax
+                cmp             rcx, 1
+                jne             .done
+                cmp             qword [rdi], 0
+.done:
+                ret
+
+; finds the end of the data segment, where the heap starts
+heap_init:
+                mov             rax, 12
+                xor             rdi, rdi
+                syscall
+
+                mov             [heap_end], rax
+                add             rax, 7
+                and             rax, -8
+                mov             [heap_top], rax
+                ret
+
+; allocates memory on the heap, it is never freed and so always comes zeroed
+;    rax -- size in bytes
+; result:
+;    rax -- address, 8-byte aligned
+alloc:
+                push            rdx
+
+                mov             rdx, [heap_top]
+                add             rdx, 7
+                and             rdx, -8
+                mov             [heap_top], rdx
+                call            extend
+                mov             rax, rdx
+
+                pop             rdx
+                ret
+
+; grows the last allocation in place, moving the break 64 KiB at a time
+;    rax -- number of bytes to add
+extend:
                 push            rdi
+                push            rsi
                 push            rcx
+                push            r11
 
-                xor             rax, rax
-                rep scasq
+                mov             rsi, [heap_top]
+                add             rsi, rax
+                cmp             rsi, [heap_end]
+                jbe             .done
+
+                lea             rdi, [rsi + 0xffff]
+                and             rdi, -0x10000
+                mov             rax, 12
+                syscall
+                cmp             rax, rdi
+                jb              out_of_memory
+                mov             [heap_end], rax
 
+.done:
+                mov             [heap_top], rsi
+                pop             r11
                 pop             rcx
+                pop             rsi
                 pop             rdi
-                pop             rax
                 ret
 
-; read long number from stdin
-;    rdi -- location for output (long number)
-;    rcx -- length of long number in qwords
-read_long:
-                push            rcx
-                push            rdi
+; reads a line of decimal digits from stdin onto the heap
+; result:
+;    rsi -- address of the digits
+;    rdx -- number of digits
+read_digits:
+                push            rbx
+                push            r14
+                push            r15
 
-                call            set_zero
+                xor             rax, rax
+                call            alloc
+                mov             r14, rax
+                xor             r15, r15
 .loop:
                 call            read_char
                 or              rax, rax
@@ -182,15 +312,19 @@ read_long:
                 cmp             rax, '9'
                 ja              .invalid_char
 
-                sub             rax, '0'
-                mov             rbx, 10
-                call            mul_long_short
-                call            add_long_short
+                mov             rbx, rax
+                mov             rax, 1
+                call            extend
+                mov             [r14 + r15], bl
+                inc             r15
                 jmp             .loop
 
 .done:
-                pop             rdi
-                pop             rcx
+                mov             rsi, r14
+                mov             rdx, r15
+                pop             r15
+                pop             r14
+                pop             rbx
                 ret
 
 .invalid_char:
@@ -209,17 +343,60 @@ read_long:
                 je              exit
                 jmp             .skip_loop
 
-; write long number to stdout
+; read long number from stdin
+; result:
+;    rdi -- address of the long number, allocated on the heap with one spare qword
+;    rcx -- length of long number in qwords
+read_long:
+                push            rsi
+                push            rdx
+                push            rbx
+
+                call            read_digits
+
+                ; 10^19 < 2^64, so every 19 digits need at most a qword
+                push            rdx
+                mov             rax, rdx
+                xor             rdx, rdx
+                mov             rbx, 19
+                div             rbx
+                pop             rdx
+                lea             rax, [8 * rax + 2 * 8]
+                call            alloc
+                mov             rdi, rax
+                mov             rcx, 1
+
+                mov             rbx, 10
+.loop:
+                test            rdx, rdx
+                jz              .done
+                movzx           rax, byte [rsi]
+                sub             rax, '0'
+                call            mul_long_short
+                call            add_long_short
+                inc             rsi
+                dec             rdx
+                jmp             .loop
+
+.done:
+                pop             rbx
+                pop             rdx
+                pop             rsi
+                ret
+
+; write long number to stdout, the number is destroyed
 ;    rdi -- argument (long number)
 ;    rcx -- length of long number in qwords
 write_long:
                 push            rax
                 push            rcx
+                push            rbp
 
-                mov             rax, 20
-                mul             rcx
-                mov             rbp, rsp
-                sub             rsp, rax
+                lea             rax, [rcx + 4 * rcx]
+                shl             rax, 2
+                mov             rbp, rax
+                call            alloc
+                add             rbp, rax
 
                 mov             rsi, rbp
 
@@ -236,76 +413,27 @@ write_long:
                 sub             rdx, rsi
                 call            print_string
 
-                mov             rsp, rbp
+                pop             rbp
                 pop             rcx
                 pop             rax
                 ret
 
-; read one char from stdin
-; result:
-;    rax == -1 if error occurs
-;    rax \in [0; 255] if OK
-read_char:
-                push            rcx
-                push            rdi
-
-                sub             rsp, 1
-                xor             rax, rax
-                xor             rdi, rdi
-                mov             rsi, rsp
-                mov             rdx, 1
-                syscall
-
-                cmp             rax, 1
-                jne             .error
-                xor             rax, rax
-                mov             al, [rsp]
-                add             rsp, 1
-
-                pop             rdi
-                pop             rcx
-                ret
-.error:
-                mov             rax, -1
-                add             rsp, 1
-                pop             rdi
-                pop             rcx
-                ret
-
-; write one char to stdout, errors are ignored
-;    al -- char
-write_char:
-                sub             rsp, 1
-                mov             [rsp], al
-
-                mov             rax, 1
-                mov             rdi, 1
-                mov             rsi, rsp
-                mov             rdx, 1
-                syscall
-                add             rsp, 1
-                ret
-
-exit:
-                mov             rax, 60
-                xor             rdi, rdi
-                syscall
-
-; print string to stdout
-;    rsi -- string
-;    rdx -- size
-print_string:
-                push            rax
-
-                mov             rax, 1
+out_of_memory:
+                mov             rsi, out_of_memory_msg
+                mov             rdx, out_of_memory_msg_size
+                call            print_string
                 mov             rdi, 1
-                syscall
-
-                pop             rax
-                ret
+                jmp             exit_status
 
 
                 section         .rodata
 invalid_char_msg:
                 db              "Invalid character: "
 invalid_char_msg_size: equ             $ - invalid_char_msg
+out_of_memory_msg:
+                db              "Out of memory", 0x0a
+out_of_memory_msg_size: equ             $ - out_of_memory_msg
+
+                section         .bss
+heap_top:       resq            1
+heap_end:       resq            1
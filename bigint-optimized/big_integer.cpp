@@ -1,8 +1,33 @@
 #include "big_integer.h"
+#include "montgomery.h"
+#include "thread_pool.h"
 
 #include <cstring>
 #include <stdexcept>
 #include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+
+namespace {
+size_t const karatsuba_threshold = 32;
+size_t const parallel_threshold = 1024;
+size_t const parallel_product_threshold = 256;
+
+std::mutex multiplication_pool_lock;
+std::unique_ptr<thread_pool> multiplication_pool;
+}
+
+void set_multiplication_threads(size_t threads) {
+    std::lock_guard<std::mutex> guard(multiplication_pool_lock);
+    // the calling thread takes part in the work as well
+    multiplication_pool.reset(threads > 1 ? new thread_pool(threads - 1) : nullptr);
+}
+
+size_t multiplication_threads() {
+    std::lock_guard<std::mutex> guard(multiplication_pool_lock);
+    return multiplication_pool ? multiplication_pool->size() + 1 : 1;
+}
 
 big_integer::big_integer() {
     negative = false;
@@ -90,18 +115,15 @@ big_integer& big_integer::operator*=(big_integer const& rhs) {
     big_integer a = abs();
     big_integer b = rhs.abs();
 
+    std::vector<uint32_t> x = a.magnitude();
+    std::vector<uint32_t> y = b.magnitude();
+    std::vector<uint32_t> r(x.size() + y.size());
+    mul_limbs(x.data(), x.size(), y.data(), y.size(), r.data(), multiplication_pool.get());
+
     *this = 0;
-    expand(a.length() + b.length() + 1);
-    for (size_t i = 0; i < b.length(); i++) {
-        uint64_t carry = 0;
-        for (size_t j = 0; j < a.length() || carry != 0; j++) {
-            size_t index = i + j;
-            carry += static_cast<uint64_t>(b.num[i]) * (j < a.length() ? a.num[j] : 0) + num[index];
-            num[index] = low32_bits_cast(carry);
-            carry >>= 32u;
-        }
+    for (uint32_t limb : r) {
+        num.push_back(limb);
     }
-
     shrink();
     if (sg) {
         (*this) = -(*this);
@@ -110,6 +132,185 @@ big_integer& big_integer::operator*=(big_integer const& rhs) {
     return *this;
 }
 
+// the factors are flattened to limb buffers up front, so the worker threads never touch
+// the reference counts of shared big_integer buffers
+big_integer product(std::vector<big_integer> const& factors) {
+    bool negative = false;
+    std::vector<std::vector<uint32_t>> limbs;
+    std::vector<size_t> prefix(1, 0);
+    for (big_integer const& factor : factors) {
+        if (factor == 0) {
+            return 0;
+        }
+        negative ^= factor.negative;
+        limbs.push_back(factor.abs().magnitude());
+        prefix.push_back(prefix.back() + limbs.back().size());
+    }
+    if (limbs.empty()) {
+        return 1;
+    }
+
+    std::vector<uint32_t> r = big_integer::product_tree(limbs, prefix, 0, limbs.size(), multiplication_pool.get());
+    big_integer result;
+    for (uint32_t limb : r) {
+        result.num.push_back(limb);
+    }
+    result.shrink();
+    return negative ? -result : result;
+}
+
+big_integer factorial(uint32_t n) {
+    // consecutive factors are packed into single limbs first
+    std::vector<big_integer> factors;
+    uint64_t packed = 1;
+    for (uint64_t i = 2; i <= n; i++) {
+        if (packed * i > UINT32_MAX) {
+            factors.push_back(static_cast<uint32_t>(packed));
+            packed = 1;
+        }
+        packed *= i;
+    }
+    factors.push_back(static_cast<uint32_t>(packed));
+    return product(factors);
+}
+
+// product of factors[first, last), the prefix sums of their lengths decide which subtrees are worth a task
+std::vector<uint32_t> big_integer::product_tree(std::vector<std::vector<uint32_t>> const& factors,
+                                                std::vector<size_t> const& prefix,
+                                                size_t first, size_t last, thread_pool* pool) {
+    if (last - first == 1) {
+        return factors[first];
+    }
+    size_t mid = first + (last - first) / 2;
+    std::vector<uint32_t> left;
+    std::vector<uint32_t> right;
+    if (pool != nullptr && prefix[last] - prefix[first] >= parallel_product_threshold) {
+        thread_pool::task_group group;
+        pool->submit(group, [&] { left = product_tree(factors, prefix, first, mid, pool); });
+        try {
+            right = product_tree(factors, prefix, mid, last, pool);
+        } catch (...) {
+            try {
+                pool->wait(group);
+            } catch (...) {
+            }
+            throw;
+        }
+        pool->wait(group);
+    } else {
+        left = product_tree(factors, prefix, first, mid, pool);
+        right = product_tree(factors, prefix, mid, last, pool);
+    }
+
+    std::vector<uint32_t> r(left.size() + right.size());
+    mul_limbs(left.data(), left.size(), right.data(), right.size(), r.data(), pool);
+    while (!r.empty() && r.back() == 0) {
+        r.pop_back();
+    }
+    return r;
+}
+
+// r[0, n + m) = a[0, n) * b[0, m)
+void big_integer::mul_basecase(uint32_t const* a, size_t n, uint32_t const* b, size_t m, uint32_t* r) {
+    std::fill(r, r + n + m, 0);
+    for (size_t i = 0; i < m; i++) {
+        uint64_t carry = 0;
+        uint64_t bi = b[i];
+        for (size_t j = 0; j < n; j++) {
+            carry += r[i + j] + a[j] * bi;
+            r[i + j] = low32_bits_cast(carry);
+            carry >>= 32u;
+        }
+        r[i + n] = low32_bits_cast(carry);
+    }
+}
+
+// r[0, 2n) = a[0, n) * b[0, n), the two half products are forked to the pool for long operands
+void big_integer::mul_karatsuba(uint32_t const* a, uint32_t const* b, size_t n, uint32_t* r, thread_pool* pool) {
+    if (n < karatsuba_threshold) {
+        mul_basecase(a, n, b, n, r);
+        return;
+    }
+    size_t h = n / 2;
+    size_t k = n - h;
+    std::vector<uint32_t> sa(a + h, a + n);
+    std::vector<uint32_t> sb(b + h, b + n);
+    sa.push_back(add_limbs(sa.data(), k, a, h));
+    sb.push_back(add_limbs(sb.data(), k, b, h));
+    std::vector<uint32_t> middle(2 * k + 2);
+
+    auto low = [=] { mul_karatsuba(a, b, h, r, pool); };
+    auto high = [=] { mul_karatsuba(a + h, b + h, k, r + 2 * h, pool); };
+    if (pool != nullptr && n >= parallel_threshold) {
+        thread_pool::task_group group;
+        pool->submit(group, low);
+        pool->submit(group, high);
+        try {
+            mul_karatsuba(sa.data(), sb.data(), k + 1, middle.data(), pool);
+        } catch (...) {
+            try {
+                pool->wait(group);
+            } catch (...) {
+            }
+            throw;
+        }
+        pool->wait(group);
+    } else {
+        low();
+        high();
+        mul_karatsuba(sa.data(), sb.data(), k + 1, middle.data(), pool);
+    }
+
+    sub_limbs(middle.data(), middle.size(), r, 2 * h);
+    sub_limbs(middle.data(), middle.size(), r + 2 * h, 2 * k);
+    add_limbs(r + h, 2 * n - h, middle.data(), middle.size());
+}
+
+void big_integer::mul_limbs(uint32_t const* a, size_t n, uint32_t const* b, size_t m, uint32_t* r, thread_pool* pool) {
+    if (n < m) {
+        std::swap(a, b);
+        std::swap(n, m);
+    }
+    if (m < karatsuba_threshold) {
+        mul_basecase(a, n, b, m, r);
+        return;
+    }
+    if (n == m) {
+        mul_karatsuba(a, b, n, r, pool);
+        return;
+    }
+
+    // unbalanced: m x m products of the slices of a
+    std::fill(r, r + n + m, 0);
+    std::vector<uint32_t> slice(2 * m);
+    for (size_t offset = 0; offset < n; offset += m) {
+        size_t len = std::min(m, n - offset);
+        mul_limbs(a + offset, len, b, m, slice.data(), pool);
+        add_limbs(r + offset, n + m - offset, slice.data(), len + m);
+    }
+}
+
+// r[0, n) += a[0, k) for k <= n, returns the carry out of r[n - 1]
+uint32_t big_integer::add_limbs(uint32_t* r, size_t n, uint32_t const* a, size_t k) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n && (i < k || carry != 0); i++) {
+        carry += static_cast<uint64_t>(r[i]) + (i < k ? a[i] : 0);
+        r[i] = low32_bits_cast(carry);
+        carry >>= 32u;
+    }
+    return low32_bits_cast(carry);
+}
+
+// r[0, n) -= a[0, k) for k <= n, the result must be non-negative
+void big_integer::sub_limbs(uint32_t* r, size_t n, uint32_t const* a, size_t k) {
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < n && (i < k || borrow != 0); i++) {
+        uint64_t diff = static_cast<uint64_t>(r[i]) - (i < k ? a[i] : 0) - borrow;
+        r[i] = low32_bits_cast(diff);
+        borrow = diff >> 63u;
+    }
+}
+
 uint32_t big_integer::trial(__uint128_t a, __uint128_t b, __uint128_t c, __uint128_t d, __uint128_t e) {
     __uint128_t x = (((a << 32u) + b) << 32u) + c;
     __uint128_t y = (d << 32u) + e;
@@ -130,7 +331,7 @@ void big_integer::difference(big_integer &r, const big_integer &dq, size_t k, si
     size_t start = k;
     for (size_t i = 0; i <= m; i++) {
         uint64_t diff = (static_cast<uint64_t>(r.get_byte(start + i)) - dq.get_byte(i) - borrow);
-        borrow = (r.get_byte(start + i) < dq.get_byte(i) + borrow);
+        borrow = (diff >> 63u);
         r.num[start + i] = low32_bits_cast(diff);
     }
 }
@@ -148,6 +349,14 @@ big_integer big_integer::quotient(big_integer const& y, uint32_t k) {
     return x;
 }
 
+uint32_t big_integer::remainder(big_integer const& y, uint32_t k) {
+    uint64_t carry = 0;
+    for (size_t i = y.length(); i-- > 0;) {
+        carry = ((carry << 32u) + y.get_byte(i)) % k;
+    }
+    return low32_bits_cast(carry);
+}
+
 big_integer& big_integer::operator/=(big_integer const& rhs) {
     bool sign = negative ^ rhs.negative;
     big_integer divs = abs();
@@ -209,8 +418,8 @@ big_integer& big_integer::operator%=(big_integer const& rhs) {
 }
 
 big_integer& big_integer::operator&=(big_integer const& rhs) {
-    negative &= rhs.negative;
     expand(rhs.length());
+    negative &= rhs.negative;
 
     for (size_t i = 0; i < length(); i++) {
         num[i] &= rhs.get_byte(i);
@@ -220,8 +429,8 @@ big_integer& big_integer::operator&=(big_integer const& rhs) {
 }
 
 big_integer& big_integer::operator|=(big_integer const& rhs) {
-    negative |= rhs.negative;
     expand(rhs.length());
+    negative |= rhs.negative;
 
     for (size_t i = 0; i < length(); i++) {
         num[i] |= rhs.get_byte(i);
@@ -231,8 +440,8 @@ big_integer& big_integer::operator|=(big_integer const& rhs) {
 }
 
 big_integer& big_integer::operator^=(big_integer const& rhs) {
-    negative ^= rhs.negative;
     expand(rhs.length());
+    negative ^= rhs.negative;
 
     for (size_t i = 0; i < length(); i++) {
         num[i] ^= rhs.get_byte(i);
@@ -241,29 +450,33 @@ big_integer& big_integer::operator^=(big_integer const& rhs) {
     return *this;
 }
 
-big_integer big_integer::binpow2(size_t n) {
-    if (n == 0) {
-        return 1;
+big_integer& big_integer::operator<<=(int rhs) {
+    size_t limbs = rhs / 32;
+    size_t bits = rhs % 32;
+    uint_vector r;
+    for (size_t i = 0; i < limbs; i++) {
+        r.push_back(0);
     }
-    if (n % 2 == 0) {
-        big_integer tmp = binpow2(n / 2);
-        return tmp * tmp;
-    } else {
-        return binpow2(n - 1) * 2;
+    for (size_t i = 0; i <= length(); i++) {
+        uint32_t low = (bits == 0 || i == 0 ? 0 : get_byte(i - 1) >> (32 - bits));
+        r.push_back((get_byte(i) << bits) | low);
     }
-}
-
-big_integer& big_integer::operator<<=(int rhs) {
-    (*this) *= binpow2(rhs);
+    num = r;
+    shrink();
     return *this;
 }
 
+// arithmetic shift of the two's complement limbs, rounds towards minus infinity
 big_integer& big_integer::operator>>=(int rhs)  {
-    bool sign = negative;
-    (*this) /= binpow2(rhs);
-    if (sign) {
-        (*this)--;
+    size_t limbs = rhs / 32;
+    size_t bits = rhs % 32;
+    uint_vector r;
+    for (size_t i = limbs; i < length(); i++) {
+        uint32_t high = (bits == 0 ? 0 : get_byte(i + 1) << (32 - bits));
+        r.push_back((get_byte(i) >> bits) | high);
     }
+    num = r;
+    shrink();
     return *this;
 }
 
@@ -384,12 +597,10 @@ bool operator<(big_integer const& a, big_integer const& b) {
         return a.negative;
     }
 
+    // equal lengths and signs: two's complement limbs order like unsigned ones
     for (int i = (int)a.length() - 1; i >= 0; i--) {
-        if (a.num[i] < b.num[i]) {
-            return !a.negative;
-        }
-        if (a.num[i] > b.num[i]) {
-            return a.negative;
+        if (a.num[i] != b.num[i]) {
+            return a.num[i] < b.num[i];
         }
     }
     return false;
@@ -407,6 +618,283 @@ bool operator>=(big_integer const& a, big_integer const& b) {
     return (b <= a);
 }
 
+big_integer gcd(big_integer const& a, big_integer const& b) {
+    big_integer x = a.abs();
+    big_integer y = b.abs();
+    if (x < y) {
+        x.swap(y);
+    }
+
+    // Lehmer: replace a run of Euclid steps by one 2x2 matrix computed on the leading bits
+    int64_t m[4];
+    while (y.length() > 2) {
+        if (big_integer::lehmer_matrix(x, y, m)) {
+            big_integer z = big_integer::linear_combination(m[0], x, m[1], y);
+            y = big_integer::linear_combination(m[2], x, m[3], y);
+            x.swap(z);
+        } else {
+            x %= y;
+            x.swap(y);
+        }
+    }
+    if (y == 0) {
+        return x;
+    }
+    x %= y;
+    if (x == 0) {
+        return y;
+    }
+
+    // both fit in 64 bits, finish with binary gcd
+    uint64_t u = x.bits_at(0);
+    uint64_t v = y.bits_at(0);
+    int shift = __builtin_ctzll(u | v);
+    u >>= __builtin_ctzll(u);
+    while (v != 0) {
+        v >>= __builtin_ctzll(v);
+        if (u > v) {
+            std::swap(u, v);
+        }
+        v -= u;
+    }
+    return big_integer::from_uint64(u << shift);
+}
+
+big_integer lcm(big_integer const& a, big_integer const& b) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    big_integer r = a / gcd(a, b) * b;
+    return r < 0 ? -r : r;
+}
+
+big_integer extended_gcd(big_integer const& a, big_integer const& b, big_integer& x, big_integer& y) {
+    bool a_negative = a.negative;
+    bool b_negative = b.negative;
+    big_integer first = a.abs();
+    big_integer second = b.abs();
+    bool swapped = first < second;
+    if (swapped) {
+        first.swap(second);
+    }
+
+    // invariant: r0 == s0 * first (mod second), r1 == s1 * first (mod second)
+    big_integer r0 = first;
+    big_integer r1 = second;
+    big_integer s0 = 1;
+    big_integer s1 = 0;
+    int64_t m[4];
+    while (r1 != 0) {
+        if (r1.length() > 2 && big_integer::lehmer_matrix(r0, r1, m)) {
+            big_integer z = big_integer::linear_combination(m[0], r0, m[1], r1);
+            r1 = big_integer::linear_combination(m[2], r0, m[3], r1);
+            r0.swap(z);
+            z = big_integer::linear_combination(m[0], s0, m[1], s1);
+            s1 = big_integer::linear_combination(m[2], s0, m[3], s1);
+            s0.swap(z);
+        } else {
+            big_integer q = r0 / r1;
+            r0 -= q * r1;
+            r0.swap(r1);
+            s0 -= q * s1;
+            s0.swap(s1);
+        }
+    }
+
+    big_integer t = (second == 0 ? big_integer() : (r0 - s0 * first) / second);
+    if (swapped) {
+        s0.swap(t);
+    }
+    x = (a_negative ? -s0 : s0);
+    y = (b_negative ? -t : t);
+    return r0;
+}
+
+big_integer mod_inverse(big_integer const& a, big_integer const& m) {
+    if (m <= 0) {
+        throw std::runtime_error("Modulus must be positive");
+    }
+    big_integer x, y;
+    if (extended_gcd(a, m, x, y) != 1) {
+        throw std::runtime_error("Inverse does not exist");
+    }
+    x %= m;
+    if (x < 0) {
+        x += m;
+    }
+    return x;
+}
+
+// product tree over the moduli, a remainder tree of M mod m_i^2 gives (M / m_i) mod m_i,
+// then x = sum r_i * c_i * M / m_i is summed back up the same tree
+big_integer crt(std::vector<uint32_t> const& residues, std::vector<uint32_t> const& moduli) {
+    if (residues.size() != moduli.size()) {
+        throw std::runtime_error("Residues and moduli sizes differ");
+    }
+    if (moduli.empty()) {
+        return 0;
+    }
+
+    std::vector<std::vector<big_integer>> tree(1);
+    for (uint32_t m : moduli) {
+        if (m == 0) {
+            throw std::runtime_error("Modulus must be positive");
+        }
+        tree[0].push_back(m);
+    }
+    while (tree.back().size() > 1) {
+        std::vector<big_integer> const& level = tree.back();
+        std::vector<big_integer> next;
+        for (size_t i = 0; i + 1 < level.size(); i += 2) {
+            next.push_back(level[i] * level[i + 1]);
+        }
+        if (level.size() % 2 == 1) {
+            next.push_back(level.back());
+        }
+        tree.push_back(next);
+    }
+    big_integer const& product = tree.back()[0];
+
+    std::vector<big_integer> rem(1, product);
+    for (size_t l = tree.size() - 1; l-- > 0;) {
+        std::vector<big_integer> next;
+        for (size_t i = 0; i < tree[l].size(); i++) {
+            next.push_back(rem[i / 2] % (tree[l][i] * tree[l][i]));
+        }
+        rem.swap(next);
+    }
+
+    std::vector<big_integer> sum;
+    for (size_t i = 0; i < moduli.size(); i++) {
+        uint32_t m = moduli[i];
+        uint32_t cofactor = big_integer::quotient(rem[i], m).get_byte(0);
+        uint64_t w = static_cast<uint64_t>(residues[i] % m) * big_integer::inverse_mod(cofactor, m) % m;
+        sum.push_back(static_cast<uint32_t>(w));
+    }
+    for (size_t l = 0; l + 1 < tree.size(); l++) {
+        std::vector<big_integer> next;
+        for (size_t i = 0; i + 1 < sum.size(); i += 2) {
+            next.push_back(sum[i] * tree[l][i + 1] + sum[i + 1] * tree[l][i]);
+        }
+        if (sum.size() % 2 == 1) {
+            next.push_back(sum.back());
+        }
+        sum.swap(next);
+    }
+    return sum[0] % product;
+}
+
+// Newton's method from an upper bound obtained by the recursive call on the top half of the bits,
+// so only the last couple of iterations work with full-length operands
+big_integer isqrt(big_integer const& a) {
+    if (a < 0) {
+        throw std::runtime_error("Square root of negative number");
+    }
+    size_t len = a.bit_length();
+    if (len <= 64) {
+        uint64_t v = a.bits_at(0);
+        uint64_t r = static_cast<uint64_t>(std::sqrt(static_cast<double>(v)));
+        while (static_cast<__uint128_t>(r) * r > v) {
+            r--;
+        }
+        while (static_cast<__uint128_t>(r + 1) * (r + 1) <= v) {
+            r++;
+        }
+        return big_integer::from_uint64(r);
+    }
+
+    int k = static_cast<int>((len - 1) / 4);
+    big_integer x = (isqrt(a >> (2 * k)) + 1) << k;
+    while (true) {
+        big_integer y = (x + a / x) >> 1;
+        if (y >= x) {
+            return x;
+        }
+        x.swap(y);
+    }
+}
+
+big_integer iroot(big_integer const& a, int k) {
+    if (k <= 0) {
+        throw std::runtime_error("Root degree must be positive");
+    }
+    if (a < 0) {
+        if (k % 2 == 0) {
+            throw std::runtime_error("Even root of negative number");
+        }
+        return -iroot(-a, k);
+    }
+    if (k == 1) {
+        return a;
+    }
+    if (k == 2) {
+        return isqrt(a);
+    }
+
+    size_t len = a.bit_length();
+    if (len <= 64) {
+        uint64_t v = a.bits_at(0);
+        uint64_t r = static_cast<uint64_t>(std::pow(static_cast<double>(v), 1.0 / k));
+        while (r > 0 && big_integer::power_exceeds(r, k, v)) {
+            r--;
+        }
+        while (!big_integer::power_exceeds(r + 1, k, v)) {
+            r++;
+        }
+        return big_integer::from_uint64(r);
+    }
+
+    int s = static_cast<int>(len / k / 2);
+    big_integer x = (s == 0 ? big_integer(1) << static_cast<int>(len / k + 1)
+                            : (iroot(a >> (k * s), k) + 1) << s);
+    while (true) {
+        big_integer p = 1;
+        big_integer base = x;
+        for (int e = k - 1; e > 0; e >>= 1) {
+            if (e & 1) {
+                p *= base;
+            }
+            if (e > 1) {
+                base *= base;
+            }
+        }
+        big_integer y = (x * (k - 1) + a / p) / k;
+        if (y >= x) {
+            return x;
+        }
+        x.swap(y);
+    }
+}
+
+big_integer powmod(big_integer const& a, big_integer const& e, big_integer const& m) {
+    if (m <= 0) {
+        throw std::runtime_error("Modulus must be positive");
+    }
+    if (e < 0) {
+        return powmod(mod_inverse(a, m), -e, m);
+    }
+    if (m == 1) {
+        return 0;
+    }
+    if (m.get_byte(0) % 2 == 1) {
+        montgomery ctx(m);
+        return ctx.from_montgomery(ctx.pow(ctx.to_montgomery(a), e));
+    }
+
+    big_integer base = a % m;
+    if (base < 0) {
+        base += m;
+    }
+    big_integer r = 1;
+    for (size_t i = e.bit_length(); i-- > 0;) {
+        r = r * r % m;
+        if (e.bits_at(i) & 1u) {
+            r = r * base % m;
+        }
+    }
+    return r;
+}
+
 
 std::string to_string(big_integer const& a) {
     if (a.length() == 0) {
@@ -463,6 +951,15 @@ void big_integer::shrink() {
     }
 }
 
+// limbs of a non-negative number
+std::vector<uint32_t> big_integer::magnitude() const {
+    std::vector<uint32_t> r(length());
+    for (size_t i = 0; i < r.size(); i++) {
+        r[i] = num[i];
+    }
+    return r;
+}
+
 uint32_t big_integer::get_byte(size_t i) const {
     if (i < length()) {
         return num[i];
@@ -473,3 +970,102 @@ uint32_t big_integer::get_byte(size_t i) const {
 uint32_t big_integer::low32_bits_cast(uint64_t value) {
     return static_cast<uint32_t>(value & UINT32_MAX);
 }
+
+size_t big_integer::bit_length() const {
+    if (length() == 0) {
+        return 0;
+    }
+    return 32 * (length() - 1) + (32 - __builtin_clz(num.back()));
+}
+
+uint64_t big_integer::bits_at(size_t shift) const {
+    size_t i = shift / 32;
+    size_t offset = shift % 32;
+    uint64_t r = get_byte(i) | (static_cast<uint64_t>(get_byte(i + 1)) << 32u);
+    if (offset != 0) {
+        r = (r >> offset) | (static_cast<uint64_t>(get_byte(i + 2)) << (64 - offset));
+    }
+    return r;
+}
+
+big_integer big_integer::from_uint64(uint64_t value) {
+    big_integer r;
+    r.num.push_back(low32_bits_cast(value));
+    r.num.push_back(low32_bits_cast(value >> 32u));
+    r.shrink();
+    return r;
+}
+
+// u * a + v * b in one pass over the limbs, signs are handled by two's complement
+big_integer big_integer::linear_combination(int64_t u, big_integer const& a, int64_t v, big_integer const& b) {
+    big_integer r;
+    size_t n = std::max(a.length(), b.length()) + 3;
+    __int128_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        carry += static_cast<__int128_t>(u) * a.get_byte(i) + static_cast<__int128_t>(v) * b.get_byte(i);
+        r.num.push_back(low32_bits_cast(static_cast<uint64_t>(carry)));
+        carry >>= 32u;
+    }
+    r.negative = (r.num.back() >> 31u);
+    r.shrink();
+    return r;
+}
+
+bool big_integer::power_exceeds(uint64_t x, int k, uint64_t v) {
+    __uint128_t p = 1;
+    for (int i = 0; i < k; i++) {
+        p *= x;
+        if (p > v) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t big_integer::inverse_mod(uint32_t a, uint32_t m) {
+    int64_t t0 = 0, t1 = 1;
+    uint32_t r0 = m, r1 = a % m;
+    while (r1 != 0) {
+        uint32_t q = r0 / r1;
+        int64_t t = t0 - static_cast<int64_t>(q) * t1;
+        t0 = t1;
+        t1 = t;
+        uint32_t r = r0 - q * r1;
+        r0 = r1;
+        r1 = r;
+    }
+    if (r0 != 1) {
+        throw std::runtime_error("Moduli are not coprime");
+    }
+    return static_cast<uint32_t>(t0 < 0 ? t0 + m : t0);
+}
+
+// Knuth, TAOCP 4.5.2, algorithm L: simulates Euclid on the leading 62 bits of a >= b > 0
+// and stores the cofactors in m, returns false if not even one quotient could be guessed
+bool big_integer::lehmer_matrix(big_integer const& a, big_integer const& b, int64_t (&m)[4]) {
+    size_t len = a.bit_length();
+    size_t shift = len > 62 ? len - 62 : 0;
+    int64_t x = static_cast<int64_t>(a.bits_at(shift));
+    int64_t y = static_cast<int64_t>(b.bits_at(shift));
+    int64_t p = 1, q = 0, r = 0, s = 1;
+    while (y + r != 0 && y + s != 0) {
+        int64_t t = (x + p) / (y + r);
+        if (t != (x + q) / (y + s)) {
+            break;
+        }
+        int64_t tmp = p - t * r;
+        p = r;
+        r = tmp;
+        tmp = q - t * s;
+        q = s;
+        s = tmp;
+        tmp = x - t * y;
+        x = y;
+        y = tmp;
+    }
+    m[0] = p;
+    m[1] = q;
+    m[2] = r;
+    m[3] = s;
+    return q != 0;
+}
@@ -4,8 +4,16 @@
 #include <cstddef>
 #include <iosfwd>
 #include <cstdint>
+#include <vector>
 #include "uint_vector.h"
 
+struct montgomery;
+struct thread_pool;
+template <size_t N>
+struct fixed_uint_batch;
+template <size_t Bits, bool Signed>
+struct wide_integer;
+
 struct big_integer {
     big_integer();
     big_integer(big_integer const& other);
@@ -48,6 +56,22 @@ struct big_integer {
 
     friend std::string to_string(big_integer const& a);
 
+    friend big_integer gcd(big_integer const& a, big_integer const& b);
+    friend big_integer extended_gcd(big_integer const& a, big_integer const& b, big_integer& x, big_integer& y);
+    friend big_integer crt(std::vector<uint32_t> const& residues, std::vector<uint32_t> const& moduli);
+    friend big_integer isqrt(big_integer const& a);
+    friend big_integer iroot(big_integer const& a, int k);
+    friend big_integer powmod(big_integer const& a, big_integer const& e, big_integer const& m);
+    friend bool is_probable_prime(big_integer const& n);
+    friend big_integer product(std::vector<big_integer> const& factors);
+
+    friend struct montgomery;
+    friend struct prime_sieve;
+    template <size_t N>
+    friend struct fixed_uint_batch;
+    template <size_t Bits, bool Signed>
+    friend struct wide_integer;
+
     void swap(big_integer& other);
 
 private:
@@ -57,18 +81,41 @@ private:
 
     void expand(size_t len);
 
-    big_integer binpow2(size_t n);
-
     uint32_t get_byte(size_t i) const;
+    std::vector<uint32_t> magnitude() const;
+
+    size_t bit_length() const;
+    uint64_t bits_at(size_t shift) const;
 
     void shrink();
 
     static uint32_t trial(__uint128_t a, __uint128_t b, __uint128_t c, __uint128_t d, __uint128_t e);
     static bool smaller(big_integer const &r, big_integer const &dq, size_t k, size_t m);
     static big_integer quotient(big_integer const& y, uint32_t k);
+    static uint32_t remainder(big_integer const& y, uint32_t k);
     static void difference(big_integer &r, big_integer const &dq, size_t k, size_t m);
 
     static uint32_t low32_bits_cast(uint64_t value);
+
+    static void mul_basecase(uint32_t const* a, size_t n, uint32_t const* b, size_t m, uint32_t* r);
+    static void mul_karatsuba(uint32_t const* a, uint32_t const* b, size_t n, uint32_t* r, thread_pool* pool);
+    static void mul_limbs(uint32_t const* a, size_t n, uint32_t const* b, size_t m, uint32_t* r, thread_pool* pool);
+    static uint32_t add_limbs(uint32_t* r, size_t n, uint32_t const* a, size_t k);
+    static void sub_limbs(uint32_t* r, size_t n, uint32_t const* a, size_t k);
+    static std::vector<uint32_t> product_tree(std::vector<std::vector<uint32_t>> const& factors,
+                                              std::vector<size_t> const& prefix,
+                                              size_t first, size_t last, thread_pool* pool);
+
+    static big_integer from_uint64(uint64_t value);
+    static big_integer linear_combination(int64_t u, big_integer const& a, int64_t v, big_integer const& b);
+    static bool power_exceeds(uint64_t x, int k, uint64_t v);
+    static uint32_t inverse_mod(uint32_t a, uint32_t m);
+    static bool lehmer_matrix(big_integer const& a, big_integer const& b, int64_t (&m)[4]);
+
+    static int jacobi(int64_t a, big_integer const& n);
+    static bool miller_rabin(montgomery const& ctx, big_integer const& base);
+    static bool strong_lucas(montgomery const& ctx, int64_t d);
+    static bool baillie_psw(big_integer const& n);
 private:
     bool negative;
     uint_vector num;
@@ -87,6 +134,33 @@ big_integer operator^(big_integer a, big_integer const& b);
 big_integer operator<<(big_integer a, int b);
 big_integer operator>>(big_integer a, int b);
 
+big_integer gcd(big_integer const& a, big_integer const& b);
+big_integer lcm(big_integer const& a, big_integer const& b);
+// returns gcd(a, b) and sets x, y so that a * x + b * y == gcd(a, b)
+big_integer extended_gcd(big_integer const& a, big_integer const& b, big_integer& x, big_integer& y);
+// inverse of a modulo m > 0 in [0, m), throws if gcd(a, m) != 1
+big_integer mod_inverse(big_integer const& a, big_integer const& m);
+// the unique x in [0, product of moduli) with x == residues[i] (mod moduli[i]), moduli must be pairwise coprime
+big_integer crt(std::vector<uint32_t> const& residues, std::vector<uint32_t> const& moduli);
+// floor of the square root and of the k-th root (truncated towards zero for negative a and odd k)
+big_integer isqrt(big_integer const& a);
+big_integer iroot(big_integer const& a, int k);
+// a^e mod m in [0, m) for m > 0, negative exponents use the modular inverse
+big_integer powmod(big_integer const& a, big_integer const& e, big_integer const& m);
+
+// products of operands longer than about 32k bits and the subtrees of product() are split
+// across this many threads, 1 by default; must not be changed while other threads are multiplying
+void set_multiplication_threads(size_t threads);
+size_t multiplication_threads();
+
+// balanced product tree instead of a left-to-right accumulation
+big_integer product(std::vector<big_integer> const& factors);
+template <typename Iterator>
+big_integer product(Iterator begin, Iterator end) {
+    return product(std::vector<big_integer>(begin, end));
+}
+big_integer factorial(uint32_t n);
+
 std::string to_string(big_integer const& a);
 std::ostream& operator<<(std::ostream& s, big_integer const& a);
 
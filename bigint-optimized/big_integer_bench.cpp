@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+
+#include "big_integer.h"
+#include "big_integer_gmp.h"
+#include "fixed_batch.h"
+#include "limb_allocator.h"
+#include "prime.h"
+
+// counts every trip to the heap made by the benchmarks
+std::atomic<size_t> heap_allocations(0);
+
+void* operator new(size_t bytes) {
+  ++heap_allocations;
+  if (void* ptr = std::malloc(bytes == 0 ? 1 : bytes))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace {
+template<typename F>
+double measure(F const& f, size_t repetitions) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i != repetitions; ++i)
+    f();
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / repetitions;
+}
+
+big_integer euclid_gcd(big_integer a, big_integer b) {
+  while (b != 0) {
+    a %= b;
+    a.swap(b);
+  }
+  return a;
+}
+
+void bench_gcd() {
+  std::default_random_engine rng(42);
+  std::printf("%-10s %12s %12s %12s\n", "gcd bits", "euclid, ms", "lehmer, ms", "mpz_gcd, ms");
+  for (size_t bits : {256, 1024, 4096, 16384}) {
+    big_integer_gmp a, b, c;
+    a.random(bits, rng);
+    b.random(bits, rng);
+    c.random(bits / 8, rng);
+    a *= c;
+    b *= c;
+    big_integer A(to_string(a));
+    big_integer B(to_string(b));
+
+    size_t repetitions = 16384 / bits;
+    double euclid = measure([&] { euclid_gcd(A, B); }, repetitions);
+    double lehmer = measure([&] { gcd(A, B); }, repetitions);
+    double gmp = measure([&] { gcd(a, b); }, repetitions);
+    std::printf("%-10zu %12.3f %12.3f %12.3f\n", bits, euclid, lehmer, gmp);
+  }
+}
+
+void bench_isqrt() {
+  std::default_random_engine rng(42);
+  std::printf("%-10s %12s %12s\n", "isqrt bits", "newton, ms", "mpz_sqrt, ms");
+  for (size_t bits : {1024, 16384, 65536}) {
+    big_integer_gmp a;
+    a.random(bits, rng);
+    big_integer A(to_string(a));
+
+    size_t repetitions = 65536 / bits;
+    double newton = measure([&] { isqrt(A); }, repetitions);
+    double gmp = measure([&] { isqrt(a); }, repetitions);
+    std::printf("%-10zu %12.3f %12.3f\n", bits, newton, gmp);
+  }
+}
+
+big_integer naive_powmod(big_integer const& a, big_integer e, big_integer const& m) {
+  big_integer r = 1;
+  big_integer base = a % m;
+  while (e != 0) {
+    if ((e & 1) != 0)
+      r = r * base % m;
+    base = base * base % m;
+    e >>= 1;
+  }
+  return r;
+}
+
+void bench_powmod() {
+  std::default_random_engine rng(42);
+  std::printf("%-10s %12s %12s %12s\n", "powm bits", "naive, ms", "montgom, ms", "mpz_powm, ms");
+  for (size_t bits : {256, 512, 1024, 2048}) {
+    big_integer_gmp a, e, m;
+    a.random(bits, rng);
+    e.random(bits, rng);
+    m.random(bits, rng);
+    m |= 1;
+    big_integer A(to_string(a)), E(to_string(e)), M(to_string(m));
+
+    size_t repetitions = 4096 / bits;
+    double naive = measure([&] { naive_powmod(A, E, M); }, repetitions);
+    double mont = measure([&] { powmod(A, E, M); }, repetitions);
+    double gmp = measure([&] { powmod(a, e, m); }, repetitions);
+    std::printf("%-10zu %12.3f %12.3f %12.3f\n", bits, naive, mont, gmp);
+  }
+}
+
+void bench_primality() {
+  std::printf("%-10s %12s %12s\n", "prime bits", "bpsw, ms", "mpz, ms");
+  for (size_t bits : {256, 512, 1024}) {
+    big_integer_gmp p = 1;
+    p <<= bits - 1;
+    while (!is_probable_prime(p))
+      p += 1;
+    big_integer P(to_string(p));
+
+    size_t repetitions = 4096 / bits;
+    double bpsw = measure([&] { is_probable_prime(P); }, repetitions);
+    double gmp = measure([&] { is_probable_prime(p); }, repetitions);
+    std::printf("%-10zu %12.3f %12.3f\n", bits, bpsw, gmp);
+  }
+}
+
+void bench_next_prime() {
+  std::default_random_engine rng(42);
+  std::printf("%-10s %12s %12s %12s\n", "next bits", "scan, ms", "sieve, ms", "mpz, ms");
+  for (size_t bits : {256, 512, 1024}) {
+    big_integer_gmp a;
+    a.random(bits, rng);
+    big_integer A(to_string(a));
+
+    size_t repetitions = 2048 / bits;
+    double scan = measure([&] {
+      big_integer x = A + 1;
+      while (!is_probable_prime(x))
+        ++x;
+    }, repetitions);
+    double sieve = measure([&] { next_prime(A); }, repetitions);
+    double gmp = measure([&] { next_prime(a); }, repetitions);
+    std::printf("%-10zu %12.3f %12.3f %12.3f\n", bits, scan, sieve, gmp);
+  }
+}
+
+// product of random halves, avoids the quadratic decimal conversion for long operands
+big_integer random_big(size_t bits, std::default_random_engine& rng) {
+  if (bits <= 4096) {
+    big_integer_gmp a;
+    a.random(bits, rng);
+    return big_integer(to_string(a));
+  }
+  return random_big(bits / 2, rng) * random_big(bits - bits / 2, rng);
+}
+
+void bench_mul() {
+  std::default_random_engine rng(42);
+  size_t const threads[] = {1, 2, 4, 8};
+  std::printf("%-10s", "mul bits");
+  for (size_t t : threads)
+    std::printf(" %9zu thr", t);
+  std::printf(" %12s\n", "mpz_mul, ms");
+  for (size_t bits : {16384, 65536, 262144, 1048576}) {
+    big_integer A = random_big(bits, rng);
+    big_integer B = random_big(bits, rng);
+    big_integer_gmp a, b;
+    a.random(bits, rng);
+    b.random(bits, rng);
+
+    size_t repetitions = std::max<size_t>(1, 262144 / bits);
+    std::printf("%-10zu", bits);
+    for (size_t t : threads) {
+      set_multiplication_threads(t);
+      std::printf(" %13.3f", measure([&] { A * B; }, repetitions));
+    }
+    set_multiplication_threads(1);
+    std::printf(" %12.3f\n", measure([&] { a * b; }, repetitions));
+  }
+}
+
+void bench_batch() {
+  std::default_random_engine rng(42);
+  size_t const size = 1 << 20;
+  fixed_uint_batch<2> a(size), b(size);
+  fixed_uint_batch<4> r(size);
+  std::vector<big_integer> x, y;
+  for (size_t i = 0; i != size; ++i) {
+    x.push_back(big_integer(static_cast<uint32_t>(rng())) << 32 | big_integer(static_cast<uint32_t>(rng())));
+    y.push_back(big_integer(static_cast<uint32_t>(rng())) << 32 | big_integer(static_cast<uint32_t>(rng())));
+    a.set(i, x[i]);
+    b.set(i, y[i]);
+  }
+  std::printf("%-10s %12s %12s\n", "2^20 x 2", "scalar, ms", "batch, ms");
+  std::printf("%-10s %12.3f %12.3f\n", "add", measure([&] {
+    for (size_t i = 0; i != size; ++i)
+      x[i] + y[i];
+  }, 1), measure([&] { add(a, b, a); }, 10));
+  std::printf("%-10s %12.3f %12.3f\n", "mul", measure([&] {
+    for (size_t i = 0; i != size; ++i)
+      x[i] * y[i];
+  }, 1), measure([&] { mul(a, b, r); }, 10));
+}
+
+void bench_allocator() {
+  std::default_random_engine rng(42);
+  std::vector<big_integer> a, b;
+  for (size_t i = 0; i != 50; ++i) {
+    a.push_back(random_big(4096, rng));
+    b.push_back(random_big(1024 + 64 * i, rng));
+  }
+  auto work = [&] {
+    for (size_t i = 0; i != a.size(); ++i) {
+      big_integer q = a[i] / b[i];
+      to_string(q % b[i]);
+    }
+  };
+
+  std::printf("%-10s %12s %12s\n", "div+str", "time, ms", "new calls");
+  for (int mode = 0; mode != 3; ++mode) {
+    pool_allocator::set_enabled(mode != 0);
+    pool_allocator::trim();
+    work();
+    size_t before = heap_allocations;
+    double ms;
+    if (mode == 2) {
+      big_integer_arena scope;
+      ms = measure(work, 1);
+    } else {
+      ms = measure(work, 1);
+    }
+    std::printf("%-10s %12.3f %12zu\n", mode == 0 ? "heap" : mode == 1 ? "pool" : "arena", ms,
+                static_cast<size_t>(heap_allocations) - before);
+  }
+  pool_allocator::set_enabled(true);
+}
+
+void bench_factorial() {
+  std::printf("%-10s %12s %12s %12s\n", "n!", "linear, ms", "tree, ms", "tree 4t, ms");
+  for (uint32_t n : {1000u, 10000u, 50000u}) {
+    std::printf("%-10u", n);
+    std::printf(" %12.3f", measure([&] {
+      big_integer r = 1;
+      for (uint32_t i = 2; i <= n; ++i)
+        r *= i;
+    }, 1));
+    std::printf(" %12.3f", measure([&] { factorial(n); }, 1));
+    set_multiplication_threads(4);
+    std::printf(" %12.3f\n", measure([&] { factorial(n); }, 1));
+    set_multiplication_threads(1);
+  }
+}
+}
+
+int main() {
+  bench_mul();
+  bench_factorial();
+  bench_batch();
+  bench_allocator();
+  bench_gcd();
+  bench_isqrt();
+  bench_powmod();
+  bench_primality();
+  bench_next_prime();
+  return 0;
+}
@@ -183,6 +183,34 @@ bool operator>=(big_integer_gmp const& a, big_integer_gmp const& b) {
   return mpz_cmp(a.mpz, b.mpz) >= 0;
 }
 
+big_integer_gmp gcd(big_integer_gmp const& a, big_integer_gmp const& b) {
+  big_integer_gmp r;
+  mpz_gcd(r.mpz, a.mpz, b.mpz);
+  return r;
+}
+
+big_integer_gmp isqrt(big_integer_gmp const& a) {
+  big_integer_gmp r;
+  mpz_sqrt(r.mpz, a.mpz);
+  return r;
+}
+
+big_integer_gmp powmod(big_integer_gmp const& a, big_integer_gmp const& e, big_integer_gmp const& m) {
+  big_integer_gmp r;
+  mpz_powm(r.mpz, a.mpz, e.mpz, m.mpz);
+  return r;
+}
+
+bool is_probable_prime(big_integer_gmp const& n) {
+  return mpz_probab_prime_p(n.mpz, 25) != 0;
+}
+
+big_integer_gmp next_prime(big_integer_gmp const& n) {
+  big_integer_gmp r;
+  mpz_nextprime(r.mpz, n.mpz);
+  return r;
+}
+
 std::string to_string(big_integer_gmp const& a) {
   char* tmp = mpz_get_str(NULL, 10, a.mpz);
   std::string res = tmp;
@@ -57,6 +57,12 @@ struct big_integer_gmp {
 
   friend std::string to_string(big_integer_gmp const& a);
 
+  friend big_integer_gmp gcd(big_integer_gmp const& a, big_integer_gmp const& b);
+  friend big_integer_gmp isqrt(big_integer_gmp const& a);
+  friend big_integer_gmp powmod(big_integer_gmp const& a, big_integer_gmp const& e, big_integer_gmp const& m);
+  friend bool is_probable_prime(big_integer_gmp const& n);
+  friend big_integer_gmp next_prime(big_integer_gmp const& n);
+
  private:
   mpz_t mpz;
 };
@@ -81,6 +87,12 @@ bool operator>(big_integer_gmp const& a, big_integer_gmp const& b);
 bool operator<=(big_integer_gmp const& a, big_integer_gmp const& b);
 bool operator>=(big_integer_gmp const& a, big_integer_gmp const& b);
 
+big_integer_gmp gcd(big_integer_gmp const& a, big_integer_gmp const& b);
+big_integer_gmp isqrt(big_integer_gmp const& a);
+big_integer_gmp powmod(big_integer_gmp const& a, big_integer_gmp const& e, big_integer_gmp const& m);
+bool is_probable_prime(big_integer_gmp const& n);
+big_integer_gmp next_prime(big_integer_gmp const& n);
+
 std::string to_string(big_integer_gmp const& a);
 std::ostream& operator<<(std::ostream& s, big_integer_gmp const& a);
 
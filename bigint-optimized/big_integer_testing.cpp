@@ -2,12 +2,18 @@
 #include <cassert>
 #include <cstdlib>
 #include <random>
+#include <thread>
 #include <vector>
 #include <utility>
 #include <gtest/gtest.h>
 
 #include "big_integer.h"
 #include "big_integer_gmp.h"
+#include "cow_vector.h"
+#include "fixed_batch.h"
+#include "limb_allocator.h"
+#include "prime.h"
+#include "wide_integer.h"
 
 TEST(correctness, two_plus_two) {
   EXPECT_EQ(big_integer(4), big_integer(2) + big_integer(2));
@@ -546,6 +552,321 @@ TEST(correctness, string_conv) {
   EXPECT_EQ("-1000000000000000", to_string(big_integer("-1000000000000000")));
 }
 
+TEST(correctness, div_all_ones_divisor) {
+  big_integer a("5983311767518815960376230064366644521178981914334273842965092379470");
+  big_integer b("170141183460469231731687303715884105727"); // 2^127 - 1
+  EXPECT_EQ(big_integer("35166745909634421014125728947"), a / b);
+  EXPECT_EQ(1, a % b);
+}
+
+TEST(correctness, gcd) {
+  EXPECT_EQ(6, gcd(big_integer(54), big_integer(24)));
+  EXPECT_EQ(6, gcd(big_integer(-54), big_integer(24)));
+  EXPECT_EQ(6, gcd(big_integer(54), big_integer(-24)));
+  EXPECT_EQ(7, gcd(big_integer(0), big_integer(-7)));
+  EXPECT_EQ(0, gcd(big_integer(0), big_integer(0)));
+
+  big_integer a("1000000000000000000000000000000000000000000000000000");
+  big_integer b("100000000000000000000000000000000000000000000000000000000000000000000000");
+  EXPECT_EQ(a, gcd(a, b));
+  EXPECT_EQ(a * 3, gcd(a * 21, b * 33));
+}
+
+TEST(correctness, lcm) {
+  EXPECT_EQ(36, lcm(big_integer(12), big_integer(-18)));
+  EXPECT_EQ(0, lcm(big_integer(0), big_integer(5)));
+  EXPECT_EQ(big_integer("1000000000000000000000000000000"),
+            lcm(big_integer("1000000000000000000000000000000"), big_integer("1000000000000000")));
+}
+
+TEST(correctness, extended_gcd) {
+  std::string const values[] = {"0", "1", "-1", "240", "-46", "1000000007",
+                                "-123456789012345678901234567890123456789",
+                                "98765432109876543210987654321098765432109876543210",
+                                "340282366920938463463374607431768211456"};
+  for (std::string const& sa : values) {
+    for (std::string const& sb : values) {
+      big_integer a(sa), b(sb), x, y;
+      big_integer g = extended_gcd(a, b, x, y);
+      EXPECT_EQ(gcd(a, b), g);
+      EXPECT_EQ(g, a * x + b * y);
+    }
+  }
+}
+
+TEST(correctness, mod_inverse) {
+  EXPECT_EQ(4, mod_inverse(big_integer(3), big_integer(11)));
+  EXPECT_EQ(7, mod_inverse(big_integer(-3), big_integer(11)));
+  EXPECT_EQ(0, mod_inverse(big_integer(5), big_integer(1)));
+
+  big_integer m("170141183460469231731687303715884105727"); // 2^127 - 1
+  big_integer a("123456789012345678901234567890");
+  big_integer x = mod_inverse(a, m);
+  EXPECT_GE(x, 0);
+  EXPECT_LT(x, m);
+  EXPECT_EQ(1, a * x % m);
+
+  EXPECT_THROW(mod_inverse(big_integer(6), big_integer(9)), std::runtime_error);
+  EXPECT_THROW(mod_inverse(big_integer(6), big_integer(0)), std::runtime_error);
+}
+
+TEST(correctness, crt) {
+  EXPECT_EQ(0, crt({}, {}));
+  EXPECT_EQ(23, crt({2, 3, 2}, {3, 5, 7}));
+  EXPECT_EQ(5, crt({5}, {4294967291u}));
+  EXPECT_THROW(crt({1, 2}, {4, 6}), std::runtime_error);
+  EXPECT_THROW(crt({1, 2}, {5}), std::runtime_error);
+
+  std::vector<uint32_t> primes;
+  for (uint32_t p = 4294967291u; primes.size() != 101; p -= 2) {
+    bool prime = true;
+    for (uint32_t d = 3; static_cast<uint64_t>(d) * d <= p && prime; d += 2)
+      prime = (p % d != 0);
+    if (prime)
+      primes.push_back(p);
+  }
+
+  big_integer x("9876543210987654321098765432109876543210987654321098765432109876543210");
+  for (size_t i = 0; i != 3; ++i)
+    x = x * x + 12345;
+  std::vector<uint32_t> residues;
+  for (uint32_t p : primes)
+    residues.push_back(std::stoul(to_string(x % p)));
+  EXPECT_EQ(x, crt(residues, primes));
+}
+
+TEST(correctness, shift_negative_exact) {
+  EXPECT_EQ(-1, big_integer(-8) >> 3);
+  EXPECT_EQ(-1, big_integer(-1) >> 100);
+  EXPECT_EQ(0, big_integer(7) >> 100);
+  EXPECT_EQ(big_integer("-633825300114114700748351602688"), big_integer(-8) << 96);
+  EXPECT_EQ(-8, big_integer("-633825300114114700748351602688") >> 96);
+}
+
+TEST(correctness, isqrt) {
+  EXPECT_EQ(0, isqrt(big_integer(0)));
+  EXPECT_EQ(1, isqrt(big_integer(3)));
+  EXPECT_EQ(2, isqrt(big_integer(4)));
+  EXPECT_EQ(big_integer("4294967295"), isqrt(big_integer("18446744073709551615")));
+  EXPECT_EQ(big_integer("4294967296"), isqrt(big_integer("18446744073709551616")));
+  EXPECT_THROW(isqrt(big_integer(-1)), std::runtime_error);
+
+  big_integer x("31415926535897932384626433832795028841971693993751058209749445923078164062862");
+  for (size_t i = 0; i != 5; ++i) {
+    EXPECT_EQ(x, isqrt(x * x));
+    EXPECT_EQ(x, isqrt(x * x + 2 * x));
+    EXPECT_EQ(x - 1, isqrt(x * x - 1));
+    x = x * x + 7;
+  }
+}
+
+TEST(correctness, iroot) {
+  EXPECT_EQ(3, iroot(big_integer(27), 3));
+  EXPECT_EQ(2, iroot(big_integer(26), 3));
+  EXPECT_EQ(-3, iroot(big_integer(-27), 3));
+  EXPECT_EQ(1, iroot(big_integer("340282366920938463463374607431768211455"), 128));
+  EXPECT_EQ(2, iroot(big_integer("340282366920938463463374607431768211456"), 128));
+  EXPECT_THROW(iroot(big_integer(-4), 2), std::runtime_error);
+  EXPECT_THROW(iroot(big_integer(4), 0), std::runtime_error);
+
+  big_integer x("2718281828459045235360287471352662497757247093699959574966967627");
+  for (int k = 3; k != 12; ++k) {
+    big_integer p = 1;
+    for (int i = 0; i != k; ++i)
+      p *= x;
+    EXPECT_EQ(x, iroot(p, k));
+    EXPECT_EQ(x - 1, iroot(p - 1, k));
+  }
+}
+
+TEST(correctness, powmod) {
+  EXPECT_EQ(445, powmod(big_integer(4), big_integer(13), big_integer(497)));
+  EXPECT_EQ(1, powmod(big_integer(4), big_integer(0), big_integer(497)));
+  EXPECT_EQ(0, powmod(big_integer(4), big_integer(13), big_integer(1)));
+  EXPECT_EQ(8, powmod(big_integer(-2), big_integer(3), big_integer(16)));
+  EXPECT_EQ(4, powmod(big_integer(3), big_integer(-1), big_integer(11)));
+  EXPECT_EQ(24, powmod(big_integer(-2), big_integer(3), big_integer(32)));
+
+  big_integer p("170141183460469231731687303715884105727"); // 2^127 - 1
+  big_integer a("123456789012345678901234567890");
+  EXPECT_EQ(a, powmod(a, p, p));
+  EXPECT_EQ(1, powmod(a, p - 1, p));
+
+  big_integer m = big_integer(1) << 130;
+  big_integer expected = 1;
+  for (size_t i = 0; i != 100; ++i)
+    expected = expected * a % m;
+  EXPECT_EQ(expected, powmod(a, big_integer(100), m));
+}
+
+TEST(correctness, is_probable_prime) {
+  EXPECT_FALSE(is_probable_prime(big_integer(-7)));
+  EXPECT_FALSE(is_probable_prime(big_integer(0)));
+  EXPECT_FALSE(is_probable_prime(big_integer(1)));
+  EXPECT_TRUE(is_probable_prime(big_integer(2)));
+  EXPECT_TRUE(is_probable_prime(big_integer(997)));
+  EXPECT_FALSE(is_probable_prime(big_integer(561)));
+  EXPECT_TRUE(is_probable_prime(big_integer(1000003)));
+  EXPECT_TRUE(is_probable_prime(big_integer(1000000007)));
+  EXPECT_FALSE(is_probable_prime(big_integer(1009 * 1013)));
+  EXPECT_TRUE(is_probable_prime(big_integer("170141183460469231731687303715884105727")));
+  EXPECT_FALSE(is_probable_prime(big_integer("340282366920938463463374607431768211457"))); // 2^128 + 1
+
+  // strong pseudoprimes to all prime bases up to 23 and 37
+  EXPECT_FALSE(is_probable_prime(big_integer("3825123056546413051")));
+  EXPECT_FALSE(is_probable_prime(big_integer("318665857834031151167461")));
+  // square of a prime
+  EXPECT_FALSE(is_probable_prime(big_integer("1000000014000000049")));
+
+  big_integer m521 = (big_integer(1) << 521) - 1;
+  EXPECT_TRUE(is_probable_prime(m521));
+  EXPECT_FALSE(is_probable_prime((big_integer(1) << 523) - 1));
+}
+
+TEST(correctness, next_prime) {
+  EXPECT_EQ(2, next_prime(big_integer(-5)));
+  EXPECT_EQ(2, next_prime(big_integer(1)));
+  EXPECT_EQ(3, next_prime(big_integer(2)));
+  EXPECT_EQ(17, next_prime(big_integer(13)));
+  EXPECT_EQ(1000003, next_prime(big_integer(1000000)));
+  EXPECT_EQ(65537, next_prime(big_integer(65521)));
+  EXPECT_EQ(big_integer("4294967311"), next_prime(big_integer("4294967291")));
+  EXPECT_EQ((big_integer(1) << 127) - 1, next_prime((big_integer(1) << 127) - 20));
+}
+
+TEST(correctness, prime_sieve) {
+  prime_sieve small(0);
+  size_t count = 0;
+  for (big_integer p = small.next(); p < 200000; p = small.next())
+    ++count;
+  EXPECT_EQ(17984u, count);
+
+  big_integer start = (big_integer(1) << 200) + 12345;
+  prime_sieve sieve(start);
+  big_integer candidate = start;
+  for (size_t i = 0; i != 10; ++i) {
+    while (!is_probable_prime(candidate))
+      ++candidate;
+    EXPECT_EQ(candidate, sieve.next());
+    ++candidate;
+  }
+}
+
+TEST(correctness, factorial) {
+  EXPECT_EQ(big_integer(1), factorial(0));
+  EXPECT_EQ(big_integer(1), factorial(1));
+  EXPECT_EQ(big_integer("2432902008176640000"), factorial(20));
+
+  big_integer expected = 1;
+  for (int i = 2; i <= 1000; ++i)
+    expected *= i;
+  EXPECT_EQ(expected, factorial(1000));
+}
+
+TEST(correctness, primorial) {
+  EXPECT_EQ(big_integer(1), primorial(1));
+  EXPECT_EQ(big_integer("6469693230"), primorial(30));
+
+  big_integer expected = 1;
+  for (int i = 2; i <= 3000; ++i)
+    if (is_probable_prime(big_integer(i)))
+      expected *= i;
+  EXPECT_EQ(expected, primorial(3000));
+}
+
+TEST(correctness, product) {
+  std::vector<big_integer> factors = {3, -5, 7};
+  EXPECT_EQ(big_integer(-105), product(factors.begin(), factors.end()));
+  EXPECT_EQ(big_integer(1), product(factors.begin(), factors.begin()));
+  factors.push_back(0);
+  EXPECT_EQ(big_integer(0), product(factors));
+}
+
+TEST(correctness, compare_negative_same_length) {
+  EXPECT_TRUE(big_integer(-22731228) < big_integer(-5399947));
+  EXPECT_FALSE(big_integer(-5399947) < big_integer(-22731228));
+}
+
+TEST(correctness, bitwise_negative_shorter) {
+  big_integer mask = (big_integer(1) << 128) - 1;
+  EXPECT_EQ(mask - 4, big_integer(-5) & mask);
+  EXPECT_EQ(big_integer(-1), big_integer(-5) | mask << 1 | 1);
+  EXPECT_EQ(-mask - 1 + 4, big_integer(-5) ^ mask);
+}
+
+TEST(correctness, arena) {
+  big_integer a = (big_integer(1) << 1000) + 12345;
+  big_integer outside;
+  {
+    big_integer_arena scope;
+    big_integer b = a * a;
+    {
+      big_integer_arena inner;
+      outside = b / 7 - a;
+    }
+    EXPECT_EQ(a * a, b);
+  }
+  EXPECT_EQ(a * a / 7 - a, outside);
+
+  std::thread other([&outside] { outside = 0; });
+  other.join();
+  EXPECT_EQ(big_integer(0), outside);
+}
+
+TEST(correctness, pool_disabled) {
+  big_integer a = (big_integer(1) << 500) - 1;
+  pool_allocator::set_enabled(false);
+  big_integer b = a * a;
+  pool_allocator::set_enabled(true);
+  EXPECT_EQ(b, a * a);
+  pool_allocator::trim();
+  EXPECT_EQ(b + 1, a * a + 1);
+}
+
+TEST(correctness, cow_vector) {
+  cow_vector<std::string> a;
+  a.push_back("a");
+  a.push_back("b");
+  cow_vector<std::string> b = a;
+  cow_vector<std::string> const& c = b;
+  EXPECT_EQ(a.cbegin(), c.begin());
+  EXPECT_FALSE(a.unique());
+
+  b.push_back(c[0]);
+  EXPECT_NE(a.cbegin(), c.begin());
+  EXPECT_TRUE(a.unique());
+  EXPECT_EQ(2u, a.size());
+  EXPECT_EQ("a", c.back());
+
+  a = b;
+  a.erase(a.cbegin());
+  a.insert(a.cend(), "c");
+  EXPECT_EQ("b", a[0]);
+  EXPECT_EQ("c", a[2]);
+  EXPECT_EQ(3u, c.size());
+
+  cow_vector<std::string> d = a;
+  d.clear();
+  EXPECT_EQ(nullptr, d.data());
+  EXPECT_EQ(3u, a.size());
+  b.clear();
+  EXPECT_TRUE(b.empty());
+}
+
+TEST(correctness, wide_integer_constexpr) {
+  constexpr wide_uint<128> x = (wide_uint<128>(1) << 100) - 1;
+  static_assert(x % 7 == 1, "2^100 - 1 mod 7");
+  static_assert(wide_uint<64>(-1) + 1 == 0, "unsigned wrap-around");
+  static_assert(wide_int<256>(-5) / 2 == -2, "truncating division");
+  static_assert(wide_int<256>(-5) % 2 == -1, "remainder keeps the dividend sign");
+  static_assert(wide_int<256>(-5) >> 1 == -3, "arithmetic shift");
+  static_assert(wide_int<256>(-1) < 0 && wide_uint<256>(-1) > 0, "signed comparison");
+
+  EXPECT_EQ("1267650600228229401496703205375", to_string(x));
+  EXPECT_EQ(big_integer(-7), big_integer(wide_int<96>(-7)));
+  EXPECT_THROW(x / 0, std::runtime_error);
+}
+
 namespace {
 size_t const number_of_iterations = 10;
 size_t const max_size = 2048;
@@ -713,6 +1034,42 @@ TEST(correctness_random, mul) {
   }
 }
 
+TEST(correctness_random, mul_karatsuba) {
+  std::default_random_engine rng(42);
+  size_t const sizes[] = {1000, 2048, 5000, 12001};
+  for (size_t sa : sizes) {
+    for (size_t sb : sizes) {
+      big_integer_gmp a, b;
+      a.random(sa, rng);
+      b.random(sb, rng);
+      b = -b;
+      big_integer_gmp c = a * b;
+      big_integer R = big_integer(to_string(a)) * big_integer(to_string(b));
+      EXPECT_EQ(to_string(c), to_string(R));
+    }
+  }
+}
+
+TEST(correctness_random, mul_parallel) {
+  std::default_random_engine rng(42);
+  big_integer_gmp a, b;
+  a.random(40000, rng);
+  b.random(36000, rng);
+  big_integer A(to_string(a)), B(to_string(b));
+  big_integer sequential = A * B;
+
+  set_multiplication_threads(4);
+  EXPECT_EQ(4u, multiplication_threads());
+  big_integer parallel = A * B;
+  big_integer square = A * A;
+  set_multiplication_threads(1);
+  EXPECT_EQ(1u, multiplication_threads());
+
+  EXPECT_EQ(sequential, parallel);
+  EXPECT_EQ(to_string(a * b), to_string(parallel));
+  EXPECT_EQ(to_string(a * a), to_string(square));
+}
+
 TEST(correctness_random, div) {
   std::default_random_engine rng(254);
   for (size_t itn = 0; itn != number_of_iterations; ++itn) {
@@ -762,6 +1119,180 @@ TEST(correctness_random, bit_shifts) {
   }
 }
 
+TEST(correctness_random, gcd) {
+  std::default_random_engine rng(42);
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    big_integer_gmp a, b, c;
+    a.random(max_size, rng);
+    b.random(max_size / 2 + itn * 97, rng);
+    c.random(max_size / 4, rng);
+    a *= c;
+    b *= c;
+    big_integer A = big_integer(to_string(a));
+    big_integer B = big_integer(to_string(b));
+    EXPECT_EQ(to_string(gcd(a, b)), to_string(gcd(A, B)));
+
+    big_integer x, y;
+    big_integer g = extended_gcd(A, -B, x, y);
+    EXPECT_EQ(to_string(gcd(a, b)), to_string(g));
+    EXPECT_EQ(g, A * x - B * y);
+  }
+}
+
+TEST(correctness_random, powmod) {
+  std::default_random_engine rng(42);
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    big_integer_gmp a, e, m;
+    a.random(max_size, rng);
+    e.random(max_size / 4, rng);
+    m.random(max_size / 2, rng);
+    m += 2;
+    big_integer R = powmod(big_integer(to_string(a)), big_integer(to_string(e)), big_integer(to_string(m)));
+    EXPECT_EQ(to_string(powmod(a, e, m)), to_string(R));
+  }
+}
+
+TEST(correctness_random, is_probable_prime) {
+  std::default_random_engine rng(42);
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    big_integer_gmp a;
+    a.random(256, rng);
+    big_integer A(to_string(a));
+    for (size_t i = 0; i != 200; ++i) {
+      EXPECT_EQ(is_probable_prime(a), is_probable_prime(A));
+      a += 1;
+      A += 1;
+    }
+  }
+}
+
+TEST(correctness_random, next_prime) {
+  std::default_random_engine rng(42);
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    big_integer_gmp a;
+    a.random(512, rng);
+    EXPECT_EQ(to_string(next_prime(a)), to_string(next_prime(big_integer(to_string(a)))));
+  }
+}
+
+TEST(correctness_random, product_parallel) {
+  std::default_random_engine rng(42);
+  std::vector<big_integer> factors;
+  for (size_t i = 0; i != 500; ++i) {
+    big_integer_gmp a;
+    a.random(1 + rng() % 2000, rng);
+    factors.push_back(big_integer(to_string(a)));
+  }
+  factors.push_back(factors[0]);
+
+  big_integer expected = 1;
+  for (big_integer const& factor : factors)
+    expected *= factor;
+
+  set_multiplication_threads(4);
+  big_integer parallel = product(factors);
+  set_multiplication_threads(1);
+  EXPECT_EQ(expected, parallel);
+  EXPECT_EQ(expected, product(factors));
+}
+
+TEST(correctness_random, batch_add) {
+  std::default_random_engine rng(42);
+  size_t const size = 1003;
+  big_integer const modulus = big_integer(1) << 96;
+  fixed_uint_batch<3> a(size), b(size), r(size);
+  std::vector<big_integer> x, y;
+  for (size_t i = 0; i != size; ++i) {
+    big_integer_gmp u, v;
+    u.random(1 + rng() % 96, rng);
+    v.random(1 + rng() % 96, rng);
+    x.push_back(big_integer(to_string(u)));
+    y.push_back(big_integer(to_string(v)));
+    a.set(i, x[i]);
+    b.set(i, y[i]);
+  }
+  add(a, b, r);
+  for (size_t i = 0; i != size; ++i)
+    EXPECT_EQ((x[i] + y[i]) % modulus, r.get(i));
+
+  a.set(0, -1);
+  b.set(0, 1);
+  add(a, b, a);
+  EXPECT_EQ(big_integer(0), a.get(0));
+}
+
+TEST(correctness_random, batch_mul) {
+  std::default_random_engine rng(42);
+  size_t const size = 1003;
+  fixed_uint_batch<2> a(size), b(size);
+  fixed_uint_batch<4> r(size);
+  std::vector<big_integer> x, y;
+  for (size_t i = 0; i != size; ++i) {
+    big_integer_gmp u, v;
+    u.random(1 + rng() % 64, rng);
+    v.random(1 + rng() % 64, rng);
+    x.push_back(big_integer(to_string(u)));
+    y.push_back(big_integer(to_string(v)));
+    a.set(i, x[i]);
+    b.set(i, y[i]);
+  }
+  mul(a, b, r);
+  for (size_t i = 0; i != size; ++i)
+    EXPECT_EQ(x[i] * y[i], r.get(i));
+
+  fixed_uint_batch<4> wrong(size + 1);
+  EXPECT_THROW(mul(a, b, wrong), std::runtime_error);
+}
+
+namespace {
+// x reduced into the range of W
+template <typename W>
+big_integer wrap(big_integer const& x, size_t bits, bool is_signed) {
+  big_integer r = x & ((big_integer(1) << static_cast<int>(bits)) - 1);
+  if (is_signed && r >= (big_integer(1) << static_cast<int>(bits - 1)))
+    r -= big_integer(1) << static_cast<int>(bits);
+  return r;
+}
+
+template <typename W>
+void check_wide(size_t bits, bool is_signed) {
+  std::default_random_engine rng(42);
+  for (size_t itn = 0; itn != 200; ++itn) {
+    big_integer_gmp u, v;
+    u.random(1 + rng() % bits, rng);
+    v.random(1 + rng() % (itn % 2 == 0 ? 32 : bits), rng);
+    big_integer x = wrap<W>(big_integer(to_string(u)) * (rng() % 2 == 0 ? 1 : -1), bits, is_signed);
+    big_integer y = wrap<W>(big_integer(to_string(v)) * (rng() % 2 == 0 ? 1 : -1), bits, is_signed);
+    W a(x), b(y);
+    int shift = static_cast<int>(rng() % bits);
+
+    EXPECT_EQ(wrap<W>(x + y, bits, is_signed), big_integer(a + b));
+    EXPECT_EQ(wrap<W>(x - y, bits, is_signed), big_integer(a - b));
+    EXPECT_EQ(wrap<W>(x * y, bits, is_signed), big_integer(a * b));
+    if (y != 0) {
+      EXPECT_EQ(wrap<W>(x / y, bits, is_signed), big_integer(a / b));
+      EXPECT_EQ(wrap<W>(x % y, bits, is_signed), big_integer(a % b));
+    }
+    EXPECT_EQ(wrap<W>(x & y, bits, is_signed), big_integer(a & b));
+    EXPECT_EQ(wrap<W>(x | y, bits, is_signed), big_integer(a | b));
+    EXPECT_EQ(wrap<W>(x ^ y, bits, is_signed), big_integer(a ^ b));
+    EXPECT_EQ(wrap<W>(~x, bits, is_signed), big_integer(~a));
+    EXPECT_EQ(wrap<W>(-x, bits, is_signed), big_integer(-a));
+    EXPECT_EQ(wrap<W>(x << shift, bits, is_signed), big_integer(a << shift));
+    EXPECT_EQ(wrap<W>(x >> shift, bits, is_signed), big_integer(a >> shift));
+    EXPECT_EQ(x < y, a < b);
+    EXPECT_EQ(x == y, a == b);
+  }
+}
+}
+
+TEST(correctness_random, wide_integer) {
+  check_wide<wide_uint<128>>(128, false);
+  check_wide<wide_int<128>>(128, true);
+  check_wide<wide_uint<256>>(256, false);
+  check_wide<wide_int<512>>(512, true);
+}
+
 // TODO: extend due to idea
 TEST(correctness_twos_complement, simple) {
   std::string a = "-36893488147419103232"; // -(1 << 65)
@@ -0,0 +1,291 @@
+#ifndef BIGINT_COW_VECTOR_H
+#define BIGINT_COW_VECTOR_H
+
+#include <cstddef>
+#include <algorithm>
+#include "vector.h"
+
+// vector<T> whose copies share one buffer until one of them is modified; non-const access
+// unshares first, const access never does. The reference count is not atomic, so copies
+// sharing a buffer must stay on one thread
+template <typename T, typename Allocator = heap_allocator>
+struct cow_vector {
+    using iterator = T*;
+    using const_iterator = T const* ;
+
+    cow_vector();                               // O(1) nothrow
+    cow_vector(cow_vector const& other);        // O(1) nothrow
+    cow_vector& operator=(cow_vector const& other); // O(1) nothrow
+
+    ~cow_vector();                              // O(N) nothrow
+
+    T& operator[](size_t i);                    // O(1) strong, O(N) if shared
+    T const& operator[](size_t i) const;        // O(1) nothrow
+
+    T* data();                                  // O(1) strong, O(N) if shared
+    T const* data() const;                      // O(1) nothrow
+    size_t size() const;                        // O(1) nothrow
+
+    T& front();                                 // O(1) strong, O(N) if shared
+    T const& front() const;                     // O(1) nothrow
+
+    T& back();                                  // O(1) strong, O(N) if shared
+    T const& back() const;                      // O(1) nothrow
+    void push_back(T const&);                   // O(1) strong, O(N) if shared
+    void pop_back();                            // O(1) strong, O(N) if shared
+
+    bool empty() const;                         // O(1) nothrow
+    bool unique() const;                        // O(1) nothrow
+
+    size_t capacity() const;                    // O(1) nothrow
+    void reserve(size_t);                       // O(N) strong
+    void shrink_to_fit();                       // O(N) strong, only an unshared buffer shrinks
+
+    void clear();                               // O(N) nothrow, a shared buffer is just released
+
+    void swap(cow_vector&);                     // O(1) nothrow
+
+    iterator begin();                           // O(1) strong, O(N) if shared
+    iterator end();                             // O(1) strong, O(N) if shared
+
+    const_iterator begin() const;               // O(1) nothrow
+    const_iterator end() const;                 // O(1) nothrow
+
+    const_iterator cbegin() const;              // O(1) nothrow
+    const_iterator cend() const;                // O(1) nothrow
+
+    iterator insert(const_iterator pos, T const&); // O(N) weak
+
+    iterator erase(const_iterator pos);         // O(N) weak
+
+    iterator erase(const_iterator first, const_iterator last); // O(N) weak
+
+private:
+    struct block {
+        block()
+            : ref_counter(1) {}
+
+        explicit block(vector<T, Allocator> const& items)
+            : ref_counter(1)
+            , items(items) {}
+
+        static void* operator new(size_t bytes) {
+            return Allocator::allocate(bytes);
+        }
+
+        static void operator delete(void* ptr, size_t bytes) {
+            Allocator::deallocate(ptr, bytes);
+        }
+
+        size_t ref_counter;
+        vector<T, Allocator> items;
+    };
+
+    vector<T, Allocator>& mutate();
+    void release();
+
+private:
+    block* block_;
+};
+
+template <typename T, typename Allocator>
+cow_vector<T, Allocator>::cow_vector()
+    : block_(nullptr) {}
+
+template <typename T, typename Allocator>
+cow_vector<T, Allocator>::cow_vector(cow_vector const& other)
+    : block_(other.block_) {
+    if (block_ != nullptr) {
+        ++block_->ref_counter;
+    }
+}
+
+template <typename T, typename Allocator>
+cow_vector<T, Allocator>& cow_vector<T, Allocator>::operator=(cow_vector const& other) {
+    cow_vector tmp(other);
+    swap(tmp);
+    return *this;
+}
+
+template <typename T, typename Allocator>
+cow_vector<T, Allocator>::~cow_vector() {
+    release();
+}
+
+template <typename T, typename Allocator>
+T& cow_vector<T, Allocator>::operator[](size_t i) {
+    return mutate()[i];
+}
+
+template <typename T, typename Allocator>
+T const& cow_vector<T, Allocator>::operator[](size_t i) const {
+    return block_->items[i];
+}
+
+template <typename T, typename Allocator>
+T* cow_vector<T, Allocator>::data() {
+    return block_ == nullptr ? nullptr : mutate().data();
+}
+
+template <typename T, typename Allocator>
+T const* cow_vector<T, Allocator>::data() const {
+    return block_ == nullptr ? nullptr : block_->items.data();
+}
+
+template <typename T, typename Allocator>
+size_t cow_vector<T, Allocator>::size() const {
+    return block_ == nullptr ? 0 : block_->items.size();
+}
+
+template <typename T, typename Allocator>
+T& cow_vector<T, Allocator>::front() {
+    return mutate().front();
+}
+
+template <typename T, typename Allocator>
+T const& cow_vector<T, Allocator>::front() const {
+    return block_->items.front();
+}
+
+template <typename T, typename Allocator>
+T& cow_vector<T, Allocator>::back() {
+    return mutate().back();
+}
+
+template <typename T, typename Allocator>
+T const& cow_vector<T, Allocator>::back() const {
+    return block_->items.back();
+}
+
+// a value from the shared buffer stays alive in the other copies while this one unshares
+template <typename T, typename Allocator>
+void cow_vector<T, Allocator>::push_back(T const& value) {
+    mutate().push_back(value);
+}
+
+template <typename T, typename Allocator>
+void cow_vector<T, Allocator>::pop_back() {
+    mutate().pop_back();
+}
+
+template <typename T, typename Allocator>
+bool cow_vector<T, Allocator>::empty() const {
+    return size() == 0;
+}
+
+template <typename T, typename Allocator>
+bool cow_vector<T, Allocator>::unique() const {
+    return block_ == nullptr || block_->ref_counter == 1;
+}
+
+template <typename T, typename Allocator>
+size_t cow_vector<T, Allocator>::capacity() const {
+    return block_ == nullptr ? 0 : block_->items.capacity();
+}
+
+template <typename T, typename Allocator>
+void cow_vector<T, Allocator>::reserve(size_t new_capacity) {
+    if (capacity() < new_capacity) {
+        mutate().reserve(new_capacity);
+    }
+}
+
+template <typename T, typename Allocator>
+void cow_vector<T, Allocator>::shrink_to_fit() {
+    if (block_ != nullptr && unique()) {
+        block_->items.shrink_to_fit();
+    }
+}
+
+template <typename T, typename Allocator>
+void cow_vector<T, Allocator>::clear() {
+    if (unique()) {
+        if (block_ != nullptr) {
+            block_->items.clear();
+        }
+    } else {
+        release();
+    }
+}
+
+template <typename T, typename Allocator>
+void cow_vector<T, Allocator>::swap(cow_vector& other) {
+    std::swap(block_, other.block_);
+}
+
+template <typename T, typename Allocator>
+typename cow_vector<T, Allocator>::iterator cow_vector<T, Allocator>::begin() {
+    return data();
+}
+
+template <typename T, typename Allocator>
+typename cow_vector<T, Allocator>::iterator cow_vector<T, Allocator>::end() {
+    T* first = data();
+    return first + size();
+}
+
+template <typename T, typename Allocator>
+typename cow_vector<T, Allocator>::const_iterator cow_vector<T, Allocator>::begin() const {
+    return data();
+}
+
+template <typename T, typename Allocator>
+typename cow_vector<T, Allocator>::const_iterator cow_vector<T, Allocator>::end() const {
+    return data() + size();
+}
+
+template <typename T, typename Allocator>
+typename cow_vector<T, Allocator>::const_iterator cow_vector<T, Allocator>::cbegin() const {
+    return begin();
+}
+
+template <typename T, typename Allocator>
+typename cow_vector<T, Allocator>::const_iterator cow_vector<T, Allocator>::cend() const {
+    return end();
+}
+
+// positions are taken before unsharing, which moves the elements to a new buffer
+template <typename T, typename Allocator>
+typename cow_vector<T, Allocator>::iterator cow_vector<T, Allocator>::insert(const_iterator pos,
+                                                                              T const& value) {
+    size_t ind = pos - cbegin();
+    vector<T, Allocator>& items = mutate();
+    return items.insert(items.cbegin() + ind, value);
+}
+
+template <typename T, typename Allocator>
+typename cow_vector<T, Allocator>::iterator cow_vector<T, Allocator>::erase(const_iterator pos) {
+    return erase(pos, pos + 1);
+}
+
+template <typename T, typename Allocator>
+typename cow_vector<T, Allocator>::iterator cow_vector<T, Allocator>::erase(const_iterator first,
+                                                                             const_iterator last) {
+    size_t ind = first - cbegin();
+    size_t count = last - first;
+    vector<T, Allocator>& items = mutate();
+    return items.erase(items.cbegin() + ind, items.cbegin() + ind + count);
+}
+
+// the only place a buffer gets unshared
+template <typename T, typename Allocator>
+vector<T, Allocator>& cow_vector<T, Allocator>::mutate() {
+    if (block_ == nullptr) {
+        block_ = new block();
+    } else if (block_->ref_counter != 1) {
+        block* copy = new block(block_->items);
+        --block_->ref_counter;
+        block_ = copy;
+    }
+    return block_->items;
+}
+
+template <typename T, typename Allocator>
+void cow_vector<T, Allocator>::release() {
+    if (block_ != nullptr && --block_->ref_counter == 0) {
+        delete block_;
+    }
+    block_ = nullptr;
+}
+
+#endif //BIGINT_COW_VECTOR_H
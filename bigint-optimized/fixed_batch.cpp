@@ -0,0 +1,115 @@
+#include "fixed_batch.h"
+
+#include <algorithm>
+#include <immintrin.h>
+
+namespace {
+// the portable kernels walk blocks of lanes limb by limb so that the inner loop vectorizes
+size_t const block = 64;
+
+void add_portable(uint32_t const* a, uint32_t const* b, uint32_t* r, size_t n, size_t stride) {
+    uint32_t carry[block];
+    for (size_t j = 0; j < stride; j += block) {
+        size_t m = std::min(block, stride - j);
+        std::fill(carry, carry + m, 0);
+        for (size_t k = 0; k < n; k++) {
+            size_t at = k * stride + j;
+            for (size_t l = 0; l < m; l++) {
+                uint64_t sum = static_cast<uint64_t>(a[at + l]) + b[at + l] + carry[l];
+                r[at + l] = static_cast<uint32_t>(sum);
+                carry[l] = static_cast<uint32_t>(sum >> 32u);
+            }
+        }
+    }
+}
+
+void mul_portable(uint32_t const* a, uint32_t const* b, uint32_t* r, size_t n, size_t stride) {
+    std::fill(r, r + 2 * n * stride, 0);
+    uint32_t carry[block];
+    for (size_t j = 0; j < stride; j += block) {
+        size_t m = std::min(block, stride - j);
+        for (size_t i = 0; i < n; i++) {
+            std::fill(carry, carry + m, 0);
+            for (size_t k = 0; k < n; k++) {
+                uint32_t const* x = a + i * stride + j;
+                uint32_t const* y = b + k * stride + j;
+                uint32_t* z = r + (i + k) * stride + j;
+                for (size_t l = 0; l < m; l++) {
+                    uint64_t t = static_cast<uint64_t>(x[l]) * y[l] + z[l] + carry[l];
+                    z[l] = static_cast<uint32_t>(t);
+                    carry[l] = static_cast<uint32_t>(t >> 32u);
+                }
+            }
+            std::copy(carry, carry + m, r + (i + n) * stride + j);
+        }
+    }
+}
+
+// x < y as a lane mask, AVX2 has no unsigned comparison
+__attribute__((target("avx2")))
+__m256i less_avx2(__m256i x, __m256i y) {
+    return _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_max_epu32(x, y), x), _mm256_set1_epi32(-1));
+}
+
+// 8 lanes at a time, the carry is kept as an all-ones mask
+__attribute__((target("avx2")))
+void add_avx2(uint32_t const* a, uint32_t const* b, uint32_t* r, size_t n, size_t stride) {
+    for (size_t j = 0; j < stride; j += 8) {
+        __m256i carry = _mm256_setzero_si256();
+        for (size_t k = 0; k < n; k++) {
+            size_t at = k * stride + j;
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + at));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + at));
+            __m256i sum = _mm256_add_epi32(x, y);
+            __m256i overflow = less_avx2(sum, x);
+            __m256i total = _mm256_sub_epi32(sum, carry);
+            carry = _mm256_or_si256(overflow, less_avx2(total, sum));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + at), total);
+        }
+    }
+}
+
+// 4 lanes at a time widened to 64 bits, x * y + z + carry always fits
+__attribute__((target("avx2")))
+void mul_avx2(uint32_t const* a, uint32_t const* b, uint32_t* r, size_t n, size_t stride) {
+    std::fill(r, r + 2 * n * stride, 0);
+    __m256i const low_halves = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
+    for (size_t j = 0; j < stride; j += 4) {
+        for (size_t i = 0; i < n; i++) {
+            __m256i x = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<__m128i const*>(a + i * stride + j)));
+            __m256i carry = _mm256_setzero_si256();
+            for (size_t k = 0; k < n; k++) {
+                __m256i y = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<__m128i const*>(b + k * stride + j)));
+                __m128i* z = reinterpret_cast<__m128i*>(r + (i + k) * stride + j);
+                __m256i t = _mm256_add_epi64(_mm256_mul_epu32(x, y), _mm256_cvtepu32_epi64(_mm_loadu_si128(z)));
+                t = _mm256_add_epi64(t, carry);
+                _mm_storeu_si128(z, _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(t, low_halves)));
+                carry = _mm256_srli_epi64(t, 32);
+            }
+            __m128i* z = reinterpret_cast<__m128i*>(r + (i + n) * stride + j);
+            _mm_storeu_si128(z, _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(carry, low_halves)));
+        }
+    }
+}
+
+bool has_avx2() {
+    static bool const supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+}
+
+void batch_add_lanes(uint32_t const* a, uint32_t const* b, uint32_t* r, size_t n, size_t stride) {
+    if (has_avx2()) {
+        add_avx2(a, b, r, n, stride);
+    } else {
+        add_portable(a, b, r, n, stride);
+    }
+}
+
+void batch_mul_lanes(uint32_t const* a, uint32_t const* b, uint32_t* r, size_t n, size_t stride) {
+    if (has_avx2()) {
+        mul_avx2(a, b, r, n, stride);
+    } else {
+        mul_portable(a, b, r, n, stride);
+    }
+}
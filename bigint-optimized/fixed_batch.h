@@ -0,0 +1,77 @@
+#ifndef BIGINT_FIXED_BATCH_H
+#define BIGINT_FIXED_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "big_integer.h"
+
+// lane kernels over limb-major storage: limb k of lane j lives at [k * stride + j],
+// stride is a multiple of 8; AVX2 is used when the CPU has it
+void batch_add_lanes(uint32_t const* a, uint32_t const* b, uint32_t* r, size_t n, size_t stride);
+void batch_mul_lanes(uint32_t const* a, uint32_t const* b, uint32_t* r, size_t n, size_t stride);
+
+// size() unsigned N-limb integers stored structure-of-arrays, arithmetic is mod 2^(32N)
+template <size_t N>
+struct fixed_uint_batch {
+    explicit fixed_uint_batch(size_t size)
+            : count(size), lanes((size + 7) / 8 * 8), limbs(N * lanes, 0) {
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    size_t stride() const {
+        return lanes;
+    }
+
+    uint32_t* data() {
+        return limbs.data();
+    }
+
+    uint32_t const* data() const {
+        return limbs.data();
+    }
+
+    // value mod 2^(32N), negative values wrap around
+    void set(size_t i, big_integer const& value) {
+        for (size_t k = 0; k < N; k++) {
+            limbs[k * lanes + i] = value.get_byte(k);
+        }
+    }
+
+    big_integer get(size_t i) const {
+        big_integer r;
+        for (size_t k = 0; k < N; k++) {
+            r.num.push_back(limbs[k * lanes + i]);
+        }
+        r.shrink();
+        return r;
+    }
+
+private:
+    size_t count;
+    size_t lanes;
+    std::vector<uint32_t> limbs;
+};
+
+template <size_t N>
+void add(fixed_uint_batch<N> const& a, fixed_uint_batch<N> const& b, fixed_uint_batch<N>& r) {
+    if (a.size() != b.size() || a.size() != r.size()) {
+        throw std::runtime_error("Batch sizes differ");
+    }
+    batch_add_lanes(a.data(), b.data(), r.data(), N, a.stride());
+}
+
+// full 2N-limb products
+template <size_t N>
+void mul(fixed_uint_batch<N> const& a, fixed_uint_batch<N> const& b, fixed_uint_batch<2 * N>& r) {
+    if (a.size() != b.size() || a.size() != r.size()) {
+        throw std::runtime_error("Batch sizes differ");
+    }
+    batch_mul_lanes(a.data(), b.data(), r.data(), N, a.stride());
+}
+
+#endif //BIGINT_FIXED_BATCH_H
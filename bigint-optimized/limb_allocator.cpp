@@ -0,0 +1,164 @@
+#include "limb_allocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+// every block starts with a header naming the chunk or size class it came from
+struct alignas(16) block_header {
+    arena_chunk* chunk;
+    size_t size_class;
+};
+
+// live counts the blocks in use plus one while the chunk is still being filled
+struct arena_chunk {
+    std::atomic<size_t> live;
+};
+
+namespace {
+size_t const header_size = sizeof(block_header);
+size_t const size_classes = 12;
+size_t const smallest_block = 32;
+size_t const large_block = size_classes;
+size_t const chunk_size = 1 << 16;
+
+// freed blocks are linked through their payload
+struct free_block {
+    free_block* next;
+};
+
+// trivially destructible, so blocks of static objects freed after the guard has run still work
+struct free_lists {
+    free_block* heads[size_classes];
+    bool enabled;
+    bool released;
+};
+
+thread_local free_lists lists = {{}, true, false};
+thread_local big_integer_arena* current_arena = nullptr;
+
+void release_lists() {
+    for (size_t c = 0; c < size_classes; c++) {
+        while (lists.heads[c] != nullptr) {
+            free_block* block = lists.heads[c];
+            lists.heads[c] = block->next;
+            operator delete(block);
+        }
+    }
+}
+
+struct free_lists_guard {
+    ~free_lists_guard() {
+        release_lists();
+        lists.released = true;
+    }
+};
+
+thread_local free_lists_guard guard;
+
+size_t size_class(size_t total) {
+    size_t c = 0;
+    while (c < size_classes && (smallest_block << c) < total) {
+        c++;
+    }
+    return c;
+}
+
+void* payload(block_header* header, arena_chunk* chunk, size_t c) {
+    header->chunk = chunk;
+    header->size_class = c;
+    return header + 1;
+}
+
+void release_chunk(arena_chunk* chunk) {
+    if (chunk->live.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        chunk->~arena_chunk();
+        operator delete(chunk);
+    }
+}
+}
+
+void* pool_allocator::allocate(size_t bytes) {
+    size_t total = bytes + header_size;
+    if (current_arena != nullptr) {
+        return current_arena->allocate(total);
+    }
+
+    size_t c = size_class(total);
+    if (c == large_block || !lists.enabled || lists.released) {
+        return payload(static_cast<block_header*>(operator new(total)), nullptr, large_block);
+    }
+    if (lists.heads[c] != nullptr) {
+        free_block* block = lists.heads[c];
+        lists.heads[c] = block->next;
+        return payload(reinterpret_cast<block_header*>(block), nullptr, c);
+    }
+    (void)&guard;
+    return payload(static_cast<block_header*>(operator new(smallest_block << c)), nullptr, c);
+}
+
+void* pool_allocator::reallocate(void* ptr, size_t old_bytes, size_t bytes) {
+    block_header* header = static_cast<block_header*>(ptr) - 1;
+    if (header->chunk == nullptr && header->size_class != large_block
+        && bytes + header_size <= (smallest_block << header->size_class)) {
+        return ptr;
+    }
+    void* grown = allocate(bytes);
+    std::memcpy(grown, ptr, std::min(old_bytes, bytes));
+    deallocate(ptr, old_bytes);
+    return grown;
+}
+
+void pool_allocator::deallocate(void* ptr, size_t) {
+    block_header* header = static_cast<block_header*>(ptr) - 1;
+    if (header->chunk != nullptr) {
+        release_chunk(header->chunk);
+    } else if (header->size_class == large_block || lists.released) {
+        operator delete(header);
+    } else {
+        (void)&guard;
+        free_block* block = reinterpret_cast<free_block*>(header);
+        block->next = lists.heads[header->size_class];
+        lists.heads[header->size_class] = block;
+    }
+}
+
+void pool_allocator::set_enabled(bool enabled) {
+    lists.enabled = enabled;
+}
+
+void pool_allocator::trim() {
+    release_lists();
+}
+
+big_integer_arena::big_integer_arena() : outer(current_arena), chunk(nullptr), used(0) {
+    current_arena = this;
+}
+
+big_integer_arena::~big_integer_arena() {
+    if (chunk != nullptr) {
+        release_chunk(chunk);
+    }
+    current_arena = outer;
+}
+
+// total includes the header, blocks stay 16-byte aligned
+void* big_integer_arena::allocate(size_t total) {
+    total = (total + header_size - 1) / header_size * header_size;
+    if (chunk == nullptr || used + total > chunk_size) {
+        size_t bytes = header_size + std::max(chunk_size, total);
+        arena_chunk* fresh = new (operator new(bytes)) arena_chunk();
+        fresh->live.store(1, std::memory_order_relaxed);
+        if (chunk != nullptr) {
+            release_chunk(chunk);
+        }
+        chunk = fresh;
+        used = 0;
+    }
+    chunk->live.fetch_add(1, std::memory_order_relaxed);
+    block_header* header = reinterpret_cast<block_header*>(reinterpret_cast<char*>(chunk) + header_size + used);
+    used += total;
+    return payload(header, chunk, 0);
+}
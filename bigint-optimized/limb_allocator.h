@@ -0,0 +1,46 @@
+#ifndef BIGINT_LIMB_ALLOCATOR_H
+#define BIGINT_LIMB_ALLOCATOR_H
+
+#include <cstddef>
+
+struct arena_chunk;
+
+// thread-local size-class free lists (32 bytes to 64 KiB) in front of operator new, or the
+// innermost big_integer_arena of the calling thread when there is one; a block may be
+// released on any thread
+struct pool_allocator {
+    static void* allocate(size_t bytes);
+    // grows in place while the block's size class has room
+    static void* reallocate(void* ptr, size_t old_bytes, size_t bytes);
+    static void deallocate(void* ptr, size_t bytes);
+
+    // turns caching off for the calling thread, blocks then go straight to operator new
+    static void set_enabled(bool enabled);
+    // hands the calling thread's cached blocks back to operator delete
+    static void trim();
+};
+
+// while a scope is alive, limb buffers of the thread are bump-allocated from 64 KiB chunks
+// that go back to the heap as a whole once nothing inside them is alive any more, so values
+// may safely outlive the scope; scopes nest and must be destroyed in reverse order
+struct big_integer_arena {
+    big_integer_arena();
+    ~big_integer_arena();
+
+    big_integer_arena(big_integer_arena const&) = delete;
+    big_integer_arena& operator=(big_integer_arena const&) = delete;
+
+private:
+    friend struct pool_allocator;
+
+    void* allocate(size_t total);
+
+    big_integer_arena* outer;
+    arena_chunk* chunk;
+    size_t used;
+};
+
+// the allocator behind every uint_vector buffer
+using limb_allocator = pool_allocator;
+
+#endif //BIGINT_LIMB_ALLOCATOR_H
@@ -0,0 +1,198 @@
+#include "montgomery.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+montgomery::montgomery(big_integer const& modulus) {
+    if (modulus <= 1 || modulus.get_byte(0) % 2 == 0) {
+        throw std::runtime_error("Montgomery modulus must be odd and greater than one");
+    }
+    mod = modulus;
+    for (size_t i = 0; i < modulus.length(); i++) {
+        m.push_back(modulus.num[i]);
+    }
+
+    // Newton iteration doubles the number of correct low bits: 3, 6, 12, 24, 48
+    uint32_t x = m[0];
+    for (size_t i = 0; i < 4; i++) {
+        x *= 2 - m[0] * x;
+    }
+    inv = -x;
+
+    t.assign(m.size() + 2, 0);
+    big_integer r = (big_integer(1) << static_cast<int>(64 * m.size())) % mod;
+    r2.assign(m.size(), 0);
+    for (size_t i = 0; i < r.length(); i++) {
+        r2[i] = r.num[i];
+    }
+}
+
+big_integer const& montgomery::modulus() const {
+    return mod;
+}
+
+montgomery::limbs montgomery::to_montgomery(big_integer const& a) const {
+    big_integer x = a % mod;
+    if (x < 0) {
+        x += mod;
+    }
+    limbs r(m.size(), 0);
+    for (size_t i = 0; i < x.length(); i++) {
+        r[i] = x.num[i];
+    }
+    mul(r, r2, r);
+    return r;
+}
+
+big_integer montgomery::from_montgomery(limbs const& a) const {
+    limbs unit(m.size(), 0);
+    unit[0] = 1;
+    limbs r;
+    mul(a, unit, r);
+
+    big_integer x;
+    for (uint32_t limb : r) {
+        x.num.push_back(limb);
+    }
+    x.shrink();
+    return x;
+}
+
+montgomery::limbs montgomery::one() const {
+    return to_montgomery(1);
+}
+
+// coarsely integrated operand scanning, t stays below 2m
+void montgomery::mul(limbs const& a, limbs const& b, limbs& r) const {
+    size_t n = m.size();
+    std::fill(t.begin(), t.end(), 0);
+    for (size_t i = 0; i < n; i++) {
+        uint64_t carry = 0;
+        uint64_t bi = b[i];
+        for (size_t j = 0; j < n; j++) {
+            carry += t[j] + a[j] * bi;
+            t[j] = static_cast<uint32_t>(carry);
+            carry >>= 32u;
+        }
+        uint64_t sum = t[n] + carry;
+        t[n] = static_cast<uint32_t>(sum);
+        t[n + 1] = static_cast<uint32_t>(sum >> 32u);
+
+        uint64_t q = static_cast<uint32_t>(t[0] * inv);
+        carry = (t[0] + q * m[0]) >> 32u;
+        for (size_t j = 1; j < n; j++) {
+            carry += t[j] + q * m[j];
+            t[j - 1] = static_cast<uint32_t>(carry);
+            carry >>= 32u;
+        }
+        sum = t[n] + carry;
+        t[n - 1] = static_cast<uint32_t>(sum);
+        t[n] = t[n + 1] + static_cast<uint32_t>(sum >> 32u);
+    }
+    if (t[n] != 0 || !less(t.data(), m)) {
+        subtract_modulus(t.data());
+    }
+    r.assign(t.begin(), t.begin() + n);
+}
+
+void montgomery::add(limbs const& a, limbs const& b, limbs& r) const {
+    size_t n = m.size();
+    r.resize(n);
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        carry += static_cast<uint64_t>(a[i]) + b[i];
+        r[i] = static_cast<uint32_t>(carry);
+        carry >>= 32u;
+    }
+    if (carry != 0 || !less(r.data(), m)) {
+        subtract_modulus(r.data());
+    }
+}
+
+void montgomery::sub(limbs const& a, limbs const& b, limbs& r) const {
+    size_t n = m.size();
+    r.resize(n);
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t diff = static_cast<uint64_t>(a[i]) - b[i] - borrow;
+        r[i] = static_cast<uint32_t>(diff);
+        borrow = diff >> 63u;
+    }
+    if (borrow != 0) {
+        uint64_t carry = 0;
+        for (size_t i = 0; i < n; i++) {
+            carry += static_cast<uint64_t>(r[i]) + m[i];
+            r[i] = static_cast<uint32_t>(carry);
+            carry >>= 32u;
+        }
+    }
+}
+
+// a / 2 mod m: add m to odd values, then shift the n + 1 limb sum right by one
+void montgomery::half(limbs& a) const {
+    size_t n = m.size();
+    uint64_t carry = 0;
+    if (a[0] & 1u) {
+        for (size_t i = 0; i < n; i++) {
+            carry += static_cast<uint64_t>(a[i]) + m[i];
+            a[i] = static_cast<uint32_t>(carry);
+            carry >>= 32u;
+        }
+    }
+    for (size_t i = 0; i + 1 < n; i++) {
+        a[i] = (a[i] >> 1u) | (a[i + 1] << 31u);
+    }
+    a[n - 1] = (a[n - 1] >> 1u) | static_cast<uint32_t>(carry << 31u);
+}
+
+// fixed 4-bit window exponentiation
+montgomery::limbs montgomery::pow(limbs const& a, big_integer const& e) const {
+    if (e < 0) {
+        throw std::runtime_error("Negative exponent");
+    }
+    std::vector<limbs> table(16);
+    table[0] = one();
+    for (size_t i = 1; i < 16; i++) {
+        mul(table[i - 1], a, table[i]);
+    }
+
+    limbs r = table[0];
+    size_t windows = (e.bit_length() + 3) / 4;
+    for (size_t w = windows; w-- > 0;) {
+        for (size_t i = 0; i < 4 && w + 1 != windows; i++) {
+            mul(r, r, r);
+        }
+        uint32_t digit = static_cast<uint32_t>(e.bits_at(4 * w) & 15u);
+        if (digit != 0) {
+            mul(r, table[digit], r);
+        }
+    }
+    return r;
+}
+
+bool montgomery::is_zero(limbs const& a) {
+    for (uint32_t limb : a) {
+        if (limb != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool montgomery::less(uint32_t const* a, limbs const& b) {
+    for (size_t i = b.size(); i-- > 0;) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i];
+        }
+    }
+    return false;
+}
+
+void montgomery::subtract_modulus(uint32_t* a) const {
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < m.size(); i++) {
+        uint64_t diff = static_cast<uint64_t>(a[i]) - m[i] - borrow;
+        a[i] = static_cast<uint32_t>(diff);
+        borrow = diff >> 63u;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef BIGINT_MONTGOMERY_H
+#define BIGINT_MONTGOMERY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "big_integer.h"
+
+// arithmetic modulo an odd m, a residue x is kept as x * 2^(32n) mod m in n limbs,
+// the scratch buffer makes one instance unsafe to share between threads
+struct montgomery {
+    using limbs = std::vector<uint32_t>;
+
+    explicit montgomery(big_integer const& modulus);
+
+    big_integer const& modulus() const;
+
+    limbs to_montgomery(big_integer const& a) const;
+    big_integer from_montgomery(limbs const& a) const;
+    limbs one() const;
+
+    void mul(limbs const& a, limbs const& b, limbs& r) const;
+    void add(limbs const& a, limbs const& b, limbs& r) const;
+    void sub(limbs const& a, limbs const& b, limbs& r) const;
+    void half(limbs& a) const;
+    limbs pow(limbs const& a, big_integer const& e) const;
+
+    static bool is_zero(limbs const& a);
+
+private:
+    big_integer mod;
+    limbs m;
+    uint32_t inv;
+    limbs r2;
+    mutable limbs t;
+
+    static bool less(uint32_t const* a, limbs const& b);
+    void subtract_modulus(uint32_t* a) const;
+};
+
+#endif //BIGINT_MONTGOMERY_H
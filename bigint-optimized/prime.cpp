@@ -0,0 +1,295 @@
+#include "prime.h"
+#include "montgomery.h"
+
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+uint32_t const trial_division_bound = 1000;
+uint32_t const sieve_bound = 1u << 16u;
+size_t const segment_length = 1u << 12u;
+size_t const random_rounds = 4;
+
+// all primes below sieve_bound
+std::vector<uint32_t> const& small_primes() {
+    static std::vector<uint32_t> const primes = [] {
+        std::vector<bool> composite(sieve_bound, false);
+        std::vector<uint32_t> result;
+        for (uint32_t i = 2; i < sieve_bound; i++) {
+            if (!composite[i]) {
+                result.push_back(i);
+                for (uint32_t j = i * i; j < sieve_bound; j += i) {
+                    composite[j] = true;
+                }
+            }
+        }
+        return result;
+    }();
+    return primes;
+}
+}
+
+bool is_probable_prime(big_integer const& n) {
+    if (n < 2) {
+        return false;
+    }
+    for (uint32_t p : small_primes()) {
+        if (p >= trial_division_bound) {
+            break;
+        }
+        if (n.length() == 1 && n.get_byte(0) == p) {
+            return true;
+        }
+        if (big_integer::remainder(n, p) == 0) {
+            return false;
+        }
+    }
+    if (n.length() <= 2 && n.bits_at(0) < static_cast<uint64_t>(trial_division_bound) * trial_division_bound) {
+        return true;
+    }
+    return big_integer::baillie_psw(n);
+}
+
+big_integer primorial(uint32_t n) {
+    std::vector<bool> composite(static_cast<size_t>(n) + 1, false);
+    std::vector<big_integer> factors;
+    uint64_t packed = 1;
+    for (uint64_t i = 2; i <= n; i++) {
+        if (composite[i]) {
+            continue;
+        }
+        for (uint64_t j = i * i; j <= n; j += i) {
+            composite[j] = true;
+        }
+        if (packed * i > UINT32_MAX) {
+            factors.push_back(static_cast<uint32_t>(packed));
+            packed = 1;
+        }
+        packed *= i;
+    }
+    factors.push_back(static_cast<uint32_t>(packed));
+    return product(factors);
+}
+
+big_integer next_prime(big_integer const& n) {
+    return prime_sieve(n + 1).next();
+}
+
+prime_sieve::prime_sieve(big_integer const& start)
+    : base(start < 2 ? big_integer(2) : start)
+    , position(0) {
+    // two primes below 2^16 share one pass of the single-limb remainder
+    std::vector<uint32_t> const& primes = small_primes();
+    residues.resize(primes.size());
+    for (size_t i = 0; i < primes.size(); i += 2) {
+        if (i + 1 == primes.size()) {
+            residues[i] = big_integer::remainder(base, primes[i]);
+        } else {
+            uint32_t r = big_integer::remainder(base, primes[i] * primes[i + 1]);
+            residues[i] = r % primes[i];
+            residues[i + 1] = r % primes[i + 1];
+        }
+    }
+    sieve_segment();
+}
+
+big_integer prime_sieve::next() {
+    while (true) {
+        for (; position < segment_length; position++) {
+            if (composite[position]) {
+                continue;
+            }
+            big_integer candidate = base + static_cast<int>(position);
+            // no factor below 2^16 means prime for everything below 2^32
+            if (candidate.length() <= 1 || big_integer::baillie_psw(candidate)) {
+                position++;
+                return candidate;
+            }
+        }
+
+        std::vector<uint32_t> const& primes = small_primes();
+        for (size_t i = 0; i < primes.size(); i++) {
+            residues[i] = static_cast<uint32_t>((residues[i] + segment_length) % primes[i]);
+        }
+        base += static_cast<int>(segment_length);
+        position = 0;
+        sieve_segment();
+    }
+}
+
+void prime_sieve::sieve_segment() {
+    composite.assign(segment_length, false);
+    std::vector<uint32_t> const& primes = small_primes();
+    uint64_t low = (base.length() <= 1 ? base.get_byte(0) : UINT64_MAX);
+    for (size_t i = 0; i < primes.size(); i++) {
+        uint64_t p = primes[i];
+        uint64_t j = (p - residues[i]) % p;
+        // the sieving primes themselves are not crossed out
+        if (low < p * p) {
+            j = p * p - low;
+        }
+        for (; j < segment_length; j += p) {
+            composite[j] = true;
+        }
+    }
+}
+
+// n odd, greater than 10^6 and without factors below 1000
+bool big_integer::baillie_psw(big_integer const& n) {
+    montgomery ctx(n);
+    if (!miller_rabin(ctx, 2)) {
+        return false;
+    }
+
+    // Selfridge's method A: first D in 5, -7, 9, -11, ... with (D / n) == -1, it exists unless n is a square
+    big_integer root = isqrt(n);
+    if (root * root == n) {
+        return false;
+    }
+    int64_t d = 5;
+    while (true) {
+        int j = jacobi(d, n);
+        if (j == -1) {
+            break;
+        }
+        if (j == 0) {
+            return false;
+        }
+        d = (d > 0 ? -(d + 2) : -d + 2);
+    }
+    if (!strong_lucas(ctx, d)) {
+        return false;
+    }
+
+    static thread_local std::mt19937 rng(std::random_device{}());
+    big_integer range = n - 3;
+    for (size_t i = 0; i < random_rounds; i++) {
+        big_integer b;
+        for (size_t j = 0; j < n.length(); j++) {
+            b.num.push_back(rng());
+        }
+        b.shrink();
+        if (!miller_rabin(ctx, b % range + 2)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// n odd and positive, a small
+int big_integer::jacobi(int64_t a, big_integer const& n) {
+    int result = 1;
+    uint32_t n8 = n.get_byte(0) % 8;
+    if (a < 0) {
+        a = -a;
+        if (n8 % 4 == 3) {
+            result = -result;
+        }
+    }
+    while (a != 0 && a % 2 == 0) {
+        a /= 2;
+        if (n8 == 3 || n8 == 5) {
+            result = -result;
+        }
+    }
+    if (a == 0) {
+        return n == 1 ? result : 0;
+    }
+    if (a % 4 == 3 && n8 % 4 == 3) {
+        result = -result;
+    }
+
+    uint64_t x = remainder(n, static_cast<uint32_t>(a));
+    uint64_t y = static_cast<uint64_t>(a);
+    while (x != 0) {
+        while (x % 2 == 0) {
+            x /= 2;
+            if (y % 8 == 3 || y % 8 == 5) {
+                result = -result;
+            }
+        }
+        std::swap(x, y);
+        if (x % 4 == 3 && y % 4 == 3) {
+            result = -result;
+        }
+        x %= y;
+    }
+    return y == 1 ? result : 0;
+}
+
+bool big_integer::miller_rabin(montgomery const& ctx, big_integer const& base) {
+    big_integer const& n = ctx.modulus();
+    big_integer d = n - 1;
+    size_t s = 0;
+    while (d.get_byte(0) % 2 == 0) {
+        d >>= 1;
+        s++;
+    }
+
+    montgomery::limbs one = ctx.one();
+    montgomery::limbs minus_one = ctx.to_montgomery(n - 1);
+    montgomery::limbs x = ctx.pow(ctx.to_montgomery(base), d);
+    if (x == one || x == minus_one) {
+        return true;
+    }
+    for (size_t i = 1; i < s; i++) {
+        ctx.mul(x, x, x);
+        if (x == minus_one) {
+            return true;
+        }
+        if (x == one) {
+            return false;
+        }
+    }
+    return false;
+}
+
+// strong Lucas test with P = 1, Q = (1 - D) / 4, n + 1 = k * 2^s:
+// U_k == 0 or V_(k * 2^r) == 0 for some r < s
+bool big_integer::strong_lucas(montgomery const& ctx, int64_t d) {
+    big_integer const& n = ctx.modulus();
+    big_integer k = n + 1;
+    size_t s = 0;
+    while (k.get_byte(0) % 2 == 0) {
+        k >>= 1;
+        s++;
+    }
+
+    montgomery::limbs u = ctx.one();
+    montgomery::limbs v = ctx.one();
+    montgomery::limbs q = ctx.to_montgomery(static_cast<int>((1 - d) / 4));
+    montgomery::limbs dm = ctx.to_montgomery(static_cast<int>(d));
+    montgomery::limbs qk = q;
+    montgomery::limbs tmp;
+    for (size_t i = k.bit_length() - 1; i-- > 0;) {
+        // U_2k = U_k V_k, V_2k = V_k^2 - 2 Q^k
+        ctx.mul(u, v, u);
+        ctx.mul(v, v, v);
+        ctx.sub(v, qk, v);
+        ctx.sub(v, qk, v);
+        ctx.mul(qk, qk, qk);
+        if (k.bits_at(i) & 1u) {
+            // U_(k+1) = (P U_k + V_k) / 2, V_(k+1) = (D U_k + P V_k) / 2
+            ctx.mul(dm, u, tmp);
+            ctx.add(u, v, u);
+            ctx.half(u);
+            ctx.add(tmp, v, v);
+            ctx.half(v);
+            ctx.mul(qk, q, qk);
+        }
+    }
+    if (montgomery::is_zero(u) || montgomery::is_zero(v)) {
+        return true;
+    }
+    for (size_t r = 1; r < s; r++) {
+        ctx.mul(v, v, v);
+        ctx.sub(v, qk, v);
+        ctx.sub(v, qk, v);
+        ctx.mul(qk, qk, qk);
+        if (montgomery::is_zero(v)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,37 @@
+#ifndef BIGINT_PRIME_H
+#define BIGINT_PRIME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "big_integer.h"
+
+// Baillie-PSW: trial division by small primes, strong Miller-Rabin to base 2 and a strong Lucas test,
+// followed by a few Miller-Rabin rounds with random bases; never wrong for primes
+bool is_probable_prime(big_integer const& n);
+
+// product of all primes <= n
+big_integer primorial(uint32_t n);
+
+// smallest probable prime greater than n
+big_integer next_prime(big_integer const& n);
+
+// walks the probable primes >= start in increasing order: residues of the segment start modulo
+// the primes below 2^16 are computed once and then shifted along, so only the candidates
+// that survive the sieve touch big_integer arithmetic
+struct prime_sieve {
+    explicit prime_sieve(big_integer const& start);
+
+    big_integer next();
+
+private:
+    void sieve_segment();
+
+private:
+    big_integer base;
+    std::vector<uint32_t> residues;
+    std::vector<bool> composite;
+    size_t position;
+};
+
+#endif //BIGINT_PRIME_H
@@ -0,0 +1,119 @@
+#include "thread_pool.h"
+
+namespace {
+// queue owned by the current thread, external threads share the last one
+thread_local thread_pool const* owner = nullptr;
+thread_local size_t owner_index = 0;
+}
+
+thread_pool::task_group::task_group()
+    : pending(0) {}
+
+thread_pool::thread_pool(size_t threads)
+    : queued(0)
+    , done(false) {
+    for (size_t i = 0; i <= threads; i++) {
+        queues.emplace_back(new queue());
+    }
+    for (size_t i = 0; i < threads; i++) {
+        workers.emplace_back(&thread_pool::work, this, i);
+    }
+}
+
+thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+        done = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+size_t thread_pool::size() const {
+    return workers.size();
+}
+
+void thread_pool::submit(task_group& group, std::function<void()> task) {
+    ++group.pending;
+    std::function<void()> wrapped = [&group, task] {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(group.error_lock);
+            if (!group.error) {
+                group.error = std::current_exception();
+            }
+        }
+        --group.pending;
+    };
+
+    queue& q = *queues[current_queue()];
+    {
+        std::lock_guard<std::mutex> guard(q.lock);
+        q.tasks.push_back(wrapped);
+    }
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+        ++queued;
+    }
+    wake.notify_one();
+}
+
+void thread_pool::wait(task_group& group) {
+    size_t index = current_queue();
+    while (group.pending != 0) {
+        if (!run_one(index)) {
+            std::this_thread::yield();
+        }
+    }
+    if (group.error) {
+        std::exception_ptr error = group.error;
+        group.error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void thread_pool::work(size_t index) {
+    owner = this;
+    owner_index = index;
+    while (true) {
+        if (run_one(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(sleep_lock);
+        wake.wait(guard, [this] { return done || queued != 0; });
+        if (done) {
+            return;
+        }
+    }
+}
+
+bool thread_pool::run_one(size_t index) {
+    std::function<void()> task;
+    for (size_t i = 0; i < queues.size() && !task; i++) {
+        queue& q = *queues[(index + i) % queues.size()];
+        std::lock_guard<std::mutex> guard(q.lock);
+        if (q.tasks.empty()) {
+            continue;
+        }
+        if (i == 0) {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+        } else {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+        }
+    }
+    if (!task) {
+        return false;
+    }
+    --queued;
+    task();
+    return true;
+}
+
+size_t thread_pool::current_queue() const {
+    return owner == this ? owner_index : queues.size() - 1;
+}
@@ -0,0 +1,56 @@
+#ifndef BIGINT_THREAD_POOL_H
+#define BIGINT_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fork-join pool: every worker pops its own deque from the back and steals from the front of the others,
+// a thread waiting for a task_group runs queued tasks instead of blocking
+struct thread_pool {
+    struct task_group {
+        task_group();
+
+        std::atomic<size_t> pending;
+        std::mutex error_lock;
+        std::exception_ptr error;
+    };
+
+    explicit thread_pool(size_t threads);
+    ~thread_pool();
+
+    thread_pool(thread_pool const&) = delete;
+    thread_pool& operator=(thread_pool const&) = delete;
+
+    size_t size() const;
+
+    void submit(task_group& group, std::function<void()> task);
+    void wait(task_group& group);
+
+private:
+    struct queue {
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void work(size_t index);
+    bool run_one(size_t index);
+    size_t current_queue() const;
+
+private:
+    std::vector<std::unique_ptr<queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queued;
+    std::atomic<bool> done;
+    std::mutex sleep_lock;
+    std::condition_variable wake;
+};
+
+#endif //BIGINT_THREAD_POOL_H
@@ -1,20 +1,15 @@
 #ifndef BIGINT_UINT_VECTOR_H
 #define BIGINT_UINT_VECTOR_H
 
-#include <memory>
-#include <vector>
 #include <cstdint>
-#include "shared_pointer.h"
+#include "cow_vector.h"
+#include "limb_allocator.h"
 
+// limbs of a big_integer; a single limb is kept inline, longer numbers share their buffer
+// between copies
 struct uint_vector {
     uint_vector();
 
-    uint_vector(uint_vector const& other);
-
-    ~uint_vector();
-
-    uint_vector& operator=(uint_vector other);
-
     void push_back(uint32_t x);
 
     void pop_back();
@@ -30,14 +25,9 @@ struct uint_vector {
     void swap(uint_vector &other);
 
 private:
+    cow_vector<uint32_t, limb_allocator> limbs;
+    uint32_t value;
     bool is_small;
-    bool empty;
-    union {
-        uint32_t value;
-        shared_pointer* data;
-    } number;
-
-    void unshare();
 };
 
 
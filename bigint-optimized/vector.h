@@ -2,10 +2,38 @@
 #define VECTOR_H
 
 #include <cstddef>
+#include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <new>
+#include <type_traits>
+
+// malloc, the default for vector
+struct heap_allocator {
+    static void* allocate(size_t bytes) {
+        void* ptr = std::malloc(bytes);
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    static void* reallocate(void* ptr, size_t, size_t bytes) {
+        void* grown = std::realloc(ptr, bytes);
+        if (grown == nullptr) {
+            throw std::bad_alloc();
+        }
+        return grown;
+    }
 
-template <typename T>
+    static void deallocate(void* ptr, size_t) {
+        std::free(ptr);
+    }
+};
+
+// Allocator provides static allocate(bytes), deallocate(ptr, bytes) and
+// reallocate(ptr, old_bytes, new_bytes), which leaves the block untouched when it throws
+template <typename T, typename Allocator = heap_allocator>
 struct vector {
     using iterator = T*;
     using const_iterator = T const* ;
@@ -63,7 +91,10 @@ private:
 
     static void destroy_all(T* vec, size_t size);
     static void copy_construct_all(T* dst, T const* src, size_t size);
+    static void copy_construct_all(T* dst, T const* src, size_t size, std::true_type);
+    static void copy_construct_all(T* dst, T const* src, size_t size, std::false_type);
     static T* allocate(size_t size);
+    static void deallocate(T* ptr, size_t size);
 
 private:
     T* data_;
@@ -71,20 +102,20 @@ private:
     size_t capacity_;
 };
 
-template <typename T>
-vector<T>::vector()
+template <typename T, typename Allocator>
+vector<T, Allocator>::vector()
     : data_(nullptr)
     , size_(0)
     , capacity_(0) {}
 
-template <typename T>
-vector<T>::vector(vector<T> const& other) {
+template <typename T, typename Allocator>
+vector<T, Allocator>::vector(vector<T, Allocator> const& other) {
     T* ptr = allocate(other.size_);
 
     try {
         copy_construct_all(ptr, other.data_, other.size_);
     } catch (...) {
-        operator delete (ptr);
+        deallocate(ptr, other.size_);
         throw;
     }
 
@@ -93,70 +124,70 @@ vector<T>::vector(vector<T> const& other) {
     capacity_ = size_;
 }
 
-template <typename T>
-vector<T>& vector<T>::operator=(vector<T> const& other) {
+template <typename T, typename Allocator>
+vector<T, Allocator>& vector<T, Allocator>::operator=(vector<T, Allocator> const& other) {
     if (this == &other) {
         return *this;
     }
 
-    vector<T> tmp(other);
+    vector<T, Allocator> tmp(other);
     swap(tmp);
     return *this;
 }
 
-template <typename T>
-vector<T>::~vector() {
+template <typename T, typename Allocator>
+vector<T, Allocator>::~vector() {
     destroy_all(data_, size_);
-    operator delete(data_);
+    deallocate(data_, capacity_);
 }
 
-template <typename T>
-T& vector<T>::operator[](size_t i) {
+template <typename T, typename Allocator>
+T& vector<T, Allocator>::operator[](size_t i) {
     return data_[i];
 }
 
-template <typename T>
-T const& vector<T>::operator[](size_t i) const {
+template <typename T, typename Allocator>
+T const& vector<T, Allocator>::operator[](size_t i) const {
     return data_[i];
 }
 
-template <typename T>
-T* vector<T>::data() {
+template <typename T, typename Allocator>
+T* vector<T, Allocator>::data() {
     return data_;
 }
 
-template <typename T>
-T const* vector<T>::data() const {
+template <typename T, typename Allocator>
+T const* vector<T, Allocator>::data() const {
     return data_;
 }
 
-template <typename T>
-size_t vector<T>::size() const {
+template <typename T, typename Allocator>
+size_t vector<T, Allocator>::size() const {
     return size_;
 }
 
-template <typename T>
-T& vector<T>::front() {
+template <typename T, typename Allocator>
+T& vector<T, Allocator>::front() {
     return *data_;
 }
 
-template <typename T>
-T const& vector<T>::front() const {
+template <typename T, typename Allocator>
+T const& vector<T, Allocator>::front() const {
     return *data_;
 }
 
-template <typename T>
-T& vector<T>::back() {
+template <typename T, typename Allocator>
+T& vector<T, Allocator>::back() {
     return data_[size_ - 1];
 }
 
-template <typename T>
-T const& vector<T>::back() const {
+template <typename T, typename Allocator>
+T const& vector<T, Allocator>::back() const {
     return data_[size_ - 1];
 }
 
-template <typename T>
-void vector<T>::push_back(T const& value) {
+template <typename T, typename Allocator>
+void vector<T, Allocator>::push_back(T const& value) {
     if (size_ != capacity_) {
         new (data_ + size_) T(value);
         ++size_;
@@ -165,81 +196,81 @@ void vector<T>::push_back(T const& value) {
     }
 }
 
-template <typename T>
-void vector<T>::pop_back() {
+template <typename T, typename Allocator>
+void vector<T, Allocator>::pop_back() {
     data_[--size_].~T();
 }
 
-template <typename T>
-bool vector<T>::empty() const {
+template <typename T, typename Allocator>
+bool vector<T, Allocator>::empty() const {
     return size_ == 0;
 }
 
-template <typename T>
-size_t vector<T>::capacity() const {
+template <typename T, typename Allocator>
+size_t vector<T, Allocator>::capacity() const {
     return capacity_;
 }
 
-template <typename T>
-void vector<T>::reserve(size_t new_capacity) {
+template <typename T, typename Allocator>
+void vector<T, Allocator>::reserve(size_t new_capacity) {
     if (capacity_ >= new_capacity) {
         return;
     }
     new_buffer(new_capacity);
 }
 
-template <typename T>
-void vector<T>::shrink_to_fit() {
+template <typename T, typename Allocator>
+void vector<T, Allocator>::shrink_to_fit() {
     if (size_ < capacity_) {
         new_buffer(size_);
     }
 }
 
-template <typename T>
-void vector<T>::clear() {
+template <typename T, typename Allocator>
+void vector<T, Allocator>::clear() {
     destroy_all(data_, size_);
     size_ = 0;
 }
 
-template <typename T>
-void vector<T>::swap(vector& other) {
+template <typename T, typename Allocator>
+void vector<T, Allocator>::swap(vector& other) {
     std::swap(data_, other.data_);
     std::swap(size_, other.size_);
     std::swap(capacity_, other.capacity_);
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::begin() {
+template <typename T, typename Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::begin() {
     return data_;
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::end() {
+template <typename T, typename Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::end() {
     return data_ + size_;
 }
 
-template <typename T>
-typename vector<T>::const_iterator vector<T>::begin() const {
+template <typename T, typename Allocator>
+typename vector<T, Allocator>::const_iterator vector<T, Allocator>::begin() const {
     return data_;
 }
 
-template <typename T>
-typename vector<T>::const_iterator vector<T>::end() const {
+template <typename T, typename Allocator>
+typename vector<T, Allocator>::const_iterator vector<T, Allocator>::end() const {
     return data_ + size_;
 }
 
-template <typename T>
-typename vector<T>::const_iterator vector<T>::cbegin() const {
+template <typename T, typename Allocator>
+typename vector<T, Allocator>::const_iterator vector<T, Allocator>::cbegin() const {
     return begin();
 }
 
-template <typename T>
-typename vector<T>::const_iterator vector<T>::cend() const {
+template <typename T, typename Allocator>
+typename vector<T, Allocator>::const_iterator vector<T, Allocator>::cend() const {
     return end();
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::insert(const_iterator pos, T const& val) {
+template <typename T, typename Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(const_iterator pos, T const& val) {
     size_t ind = pos - begin();
     push_back(val);
 
@@ -250,13 +281,13 @@ typename vector<T>::iterator vector<T>::insert(const_iterator pos, T const& val)
     return begin() + ind;
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::erase(const_iterator pos) {
+template <typename T, typename Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::erase(const_iterator pos) {
     return erase(pos, pos + 1);
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::erase(const_iterator first, const_iterator last) {
+template <typename T, typename Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::erase(const_iterator first, const_iterator last) {
     ptrdiff_t shift = first - begin();
     std::move(last, cend(), begin() + shift);
 
@@ -269,22 +300,29 @@ typename vector<T>::iterator vector<T>::erase(const_iterator first, const_iterat
     return begin() + shift;
 }
 
-template <typename T>
-size_t vector<T>::increase_capacity() const {
+template <typename T, typename Allocator>
+size_t vector<T, Allocator>::increase_capacity() const {
     return capacity_ == 0 ? 1 : capacity_ * 2;
 }
 
-template <typename T>
-void vector<T>::push_back_realloc(T const& value) {
+template <typename T, typename Allocator>
+void vector<T, Allocator>::push_back_realloc(T const& value) {
     T tmp(value);
     new_buffer(increase_capacity());
     new (data_ + size_) T(tmp);
     ++size_;
 }
 
-template <typename T>
-void vector<T>::new_buffer(size_t new_capacity) {
-    vector<T> tmp;
+template <typename T, typename Allocator>
+void vector<T, Allocator>::new_buffer(size_t new_capacity) {
+    // trivially copyable elements are moved along with the block, possibly in place
+    if (std::is_trivially_copyable<T>::value && data_ != nullptr && new_capacity != 0) {
+        data_ = static_cast<T*>(Allocator::reallocate(data_, capacity_ * sizeof(T), new_capacity * sizeof(T)));
+        capacity_ = new_capacity;
+        return;
+    }
+
+    vector<T, Allocator> tmp;
     if (new_capacity != 0) {
         tmp.data_ = allocate(new_capacity);
         copy_construct_all(tmp.data_, data_, size_);
@@ -294,16 +332,28 @@ void vector<T>::new_buffer(size_t new_capacity) {
     swap(tmp);
 }
 
-template <typename T>
-void vector<T>::destroy_all(T* vec, size_t size) {
+template <typename T, typename Allocator>
+void vector<T, Allocator>::destroy_all(T* vec, size_t size) {
     while (size > 0) {
         size--;
         vec[size].~T();
     }
 }
 
-template <typename T>
-void vector<T>::copy_construct_all(T* dst, T const* src, size_t size) {
+template <typename T, typename Allocator>
+void vector<T, Allocator>::copy_construct_all(T* dst, T const* src, size_t size) {
+    copy_construct_all(dst, src, size, std::is_trivially_copyable<T>());
+}
+
+template <typename T, typename Allocator>
+void vector<T, Allocator>::copy_construct_all(T* dst, T const* src, size_t size, std::true_type) {
+    if (size != 0) {
+        std::memcpy(dst, src, size * sizeof(T));
+    }
+}
+
+template <typename T, typename Allocator>
+void vector<T, Allocator>::copy_construct_all(T* dst, T const* src, size_t size, std::false_type) {
     size_t i = 0;
 
     try {
@@ -316,9 +366,16 @@ void vector<T>::copy_construct_all(T* dst, T const* src, size_t size) {
     }
 }
 
-template <typename T>
-T* vector<T>::allocate(size_t size) {
-    return size == 0 ? nullptr : static_cast<T*>(operator new(size * sizeof(T)));
+template <typename T, typename Allocator>
+T* vector<T, Allocator>::allocate(size_t size) {
+    return size == 0 ? nullptr : static_cast<T*>(Allocator::allocate(size * sizeof(T)));
+}
+
+template <typename T, typename Allocator>
+void vector<T, Allocator>::deallocate(T* ptr, size_t size) {
+    if (ptr != nullptr) {
+        Allocator::deallocate(ptr, size * sizeof(T));
+    }
 }
 
 #endif // VECTOR_H
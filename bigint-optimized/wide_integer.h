@@ -0,0 +1,342 @@
+#ifndef BIGINT_WIDE_INTEGER_H
+#define BIGINT_WIDE_INTEGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include "big_integer.h"
+
+// Bits-wide two's complement integer kept in an inline array of 32-bit limbs, arithmetic wraps
+// mod 2^Bits; every loop has a compile-time trip count, so the optimizer unrolls them
+template <size_t Bits, bool Signed>
+struct wide_integer {
+    static_assert(Bits > 0 && Bits % 32 == 0, "Width must be a positive multiple of 32 bits");
+
+    constexpr wide_integer() : limbs{} {
+    }
+
+    constexpr wide_integer(int a) : limbs{} {
+        for (size_t i = 0; i < N; i++) {
+            limbs[i] = a < 0 ? UINT32_MAX : 0;
+        }
+        limbs[0] = static_cast<uint32_t>(a);
+    }
+
+    constexpr wide_integer(uint32_t a) : limbs{} {
+        limbs[0] = a;
+    }
+
+    constexpr wide_integer(uint64_t a) : limbs{} {
+        limbs[0] = static_cast<uint32_t>(a);
+        if (N > 1) {
+            limbs[1] = static_cast<uint32_t>(a >> 32u);
+        }
+    }
+
+    // a mod 2^Bits
+    explicit wide_integer(big_integer const& a) : limbs{} {
+        for (size_t i = 0; i < N; i++) {
+            limbs[i] = a.get_byte(i);
+        }
+    }
+
+    explicit wide_integer(std::string const& str) : wide_integer(big_integer(str)) {
+    }
+
+    explicit operator big_integer() const {
+        big_integer r;
+        r.negative = is_negative();
+        for (size_t i = 0; i < N; i++) {
+            r.num.push_back(limbs[i]);
+        }
+        r.shrink();
+        return r;
+    }
+
+    constexpr wide_integer& operator+=(wide_integer const& rhs) {
+        uint64_t carry = 0;
+        for (size_t i = 0; i < N; i++) {
+            uint64_t sum = carry + limbs[i] + rhs.limbs[i];
+            limbs[i] = static_cast<uint32_t>(sum);
+            carry = sum >> 32u;
+        }
+        return *this;
+    }
+
+    constexpr wide_integer& operator-=(wide_integer const& rhs) {
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < N; i++) {
+            uint64_t diff = static_cast<uint64_t>(limbs[i]) - rhs.limbs[i] - borrow;
+            limbs[i] = static_cast<uint32_t>(diff);
+            borrow = diff >> 63u;
+        }
+        return *this;
+    }
+
+    // the low N limbs of the product are the same for signed and unsigned operands
+    constexpr wide_integer& operator*=(wide_integer const& rhs) {
+        wide_integer r;
+        for (size_t i = 0; i < N; i++) {
+            uint64_t carry = 0;
+            for (size_t j = 0; i + j < N; j++) {
+                uint64_t t = static_cast<uint64_t>(limbs[i]) * rhs.limbs[j] + r.limbs[i + j] + carry;
+                r.limbs[i + j] = static_cast<uint32_t>(t);
+                carry = t >> 32u;
+            }
+        }
+        return *this = r;
+    }
+
+    // truncates towards zero like big_integer
+    constexpr wide_integer& operator/=(wide_integer const& rhs) {
+        wide_integer q;
+        wide_integer r;
+        divide(*this, rhs, q, r);
+        return *this = q;
+    }
+
+    constexpr wide_integer& operator%=(wide_integer const& rhs) {
+        wide_integer q;
+        wide_integer r;
+        divide(*this, rhs, q, r);
+        return *this = r;
+    }
+
+    constexpr wide_integer& operator&=(wide_integer const& rhs) {
+        for (size_t i = 0; i < N; i++) {
+            limbs[i] &= rhs.limbs[i];
+        }
+        return *this;
+    }
+
+    constexpr wide_integer& operator|=(wide_integer const& rhs) {
+        for (size_t i = 0; i < N; i++) {
+            limbs[i] |= rhs.limbs[i];
+        }
+        return *this;
+    }
+
+    constexpr wide_integer& operator^=(wide_integer const& rhs) {
+        for (size_t i = 0; i < N; i++) {
+            limbs[i] ^= rhs.limbs[i];
+        }
+        return *this;
+    }
+
+    constexpr wide_integer& operator<<=(int rhs) {
+        size_t shift = static_cast<size_t>(rhs) / 32;
+        size_t bits = static_cast<size_t>(rhs) % 32;
+        for (size_t i = N; i-- > 0;) {
+            uint32_t high = (i >= shift ? limbs[i - shift] << bits : 0);
+            uint32_t low = (bits != 0 && i >= shift + 1 ? limbs[i - shift - 1] >> (32 - bits) : 0);
+            limbs[i] = high | low;
+        }
+        return *this;
+    }
+
+    // arithmetic for wide_int, logical for wide_uint
+    constexpr wide_integer& operator>>=(int rhs) {
+        size_t shift = static_cast<size_t>(rhs) / 32;
+        size_t bits = static_cast<size_t>(rhs) % 32;
+        uint32_t fill = is_negative() ? UINT32_MAX : 0;
+        for (size_t i = 0; i < N; i++) {
+            uint32_t low = (shift < N - i ? limbs[i + shift] : fill) >> bits;
+            uint32_t high = (bits == 0 ? 0 : (shift + 1 < N - i ? limbs[i + shift + 1] : fill) << (32 - bits));
+            limbs[i] = low | high;
+        }
+        return *this;
+    }
+
+    constexpr wide_integer operator+() const {
+        return *this;
+    }
+
+    constexpr wide_integer operator-() const {
+        wide_integer r = ~*this;
+        return r += 1;
+    }
+
+    constexpr wide_integer operator~() const {
+        wide_integer r;
+        for (size_t i = 0; i < N; i++) {
+            r.limbs[i] = ~limbs[i];
+        }
+        return r;
+    }
+
+    constexpr wide_integer& operator++() {
+        return *this += 1;
+    }
+
+    constexpr wide_integer operator++(int) {
+        wide_integer r = *this;
+        *this += 1;
+        return r;
+    }
+
+    constexpr wide_integer& operator--() {
+        return *this -= 1;
+    }
+
+    constexpr wide_integer operator--(int) {
+        wide_integer r = *this;
+        *this -= 1;
+        return r;
+    }
+
+    friend constexpr bool operator==(wide_integer const& a, wide_integer const& b) {
+        for (size_t i = 0; i < N; i++) {
+            if (a.limbs[i] != b.limbs[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend constexpr bool operator!=(wide_integer const& a, wide_integer const& b) {
+        return !(a == b);
+    }
+
+    friend constexpr bool operator<(wide_integer const& a, wide_integer const& b) {
+        if (a.is_negative() != b.is_negative()) {
+            return a.is_negative();
+        }
+        return less_unsigned(a, b);
+    }
+
+    friend constexpr bool operator>(wide_integer const& a, wide_integer const& b) {
+        return b < a;
+    }
+
+    friend constexpr bool operator<=(wide_integer const& a, wide_integer const& b) {
+        return !(b < a);
+    }
+
+    friend constexpr bool operator>=(wide_integer const& a, wide_integer const& b) {
+        return !(a < b);
+    }
+
+    friend constexpr wide_integer operator+(wide_integer a, wide_integer const& b) {
+        return a += b;
+    }
+
+    friend constexpr wide_integer operator-(wide_integer a, wide_integer const& b) {
+        return a -= b;
+    }
+
+    friend constexpr wide_integer operator*(wide_integer a, wide_integer const& b) {
+        return a *= b;
+    }
+
+    friend constexpr wide_integer operator/(wide_integer a, wide_integer const& b) {
+        return a /= b;
+    }
+
+    friend constexpr wide_integer operator%(wide_integer a, wide_integer const& b) {
+        return a %= b;
+    }
+
+    friend constexpr wide_integer operator&(wide_integer a, wide_integer const& b) {
+        return a &= b;
+    }
+
+    friend constexpr wide_integer operator|(wide_integer a, wide_integer const& b) {
+        return a |= b;
+    }
+
+    friend constexpr wide_integer operator^(wide_integer a, wide_integer const& b) {
+        return a ^= b;
+    }
+
+    friend constexpr wide_integer operator<<(wide_integer a, int b) {
+        return a <<= b;
+    }
+
+    friend constexpr wide_integer operator>>(wide_integer a, int b) {
+        return a >>= b;
+    }
+
+    friend std::string to_string(wide_integer const& a) {
+        return ::to_string(big_integer(a));
+    }
+
+    friend std::ostream& operator<<(std::ostream& s, wide_integer const& a) {
+        return s << big_integer(a);
+    }
+
+private:
+    static constexpr size_t N = Bits / 32;
+    uint32_t limbs[N];
+
+    constexpr bool is_negative() const {
+        return Signed && (limbs[N - 1] >> 31u) != 0;
+    }
+
+    static constexpr bool less_unsigned(wide_integer const& a, wide_integer const& b) {
+        for (size_t i = N; i-- > 0;) {
+            if (a.limbs[i] != b.limbs[i]) {
+                return a.limbs[i] < b.limbs[i];
+            }
+        }
+        return false;
+    }
+
+    // q and r of the magnitudes, then the signs of C++ truncating division
+    static constexpr void divide(wide_integer a, wide_integer b, wide_integer& q, wide_integer& r) {
+        if (b == 0) {
+            throw std::runtime_error("Division by zero");
+        }
+        bool quotient_negative = a.is_negative() != b.is_negative();
+        bool remainder_negative = a.is_negative();
+        if (a.is_negative()) {
+            a = -a;
+        }
+        if (b.is_negative()) {
+            b = -b;
+        }
+
+        q = 0;
+        r = 0;
+        size_t top = N;
+        while (top > 1 && b.limbs[top - 1] == 0) {
+            top--;
+        }
+        if (top == 1) {
+            uint64_t rest = 0;
+            for (size_t i = N; i-- > 0;) {
+                uint64_t current = (rest << 32u) | a.limbs[i];
+                q.limbs[i] = static_cast<uint32_t>(current / b.limbs[0]);
+                rest = current % b.limbs[0];
+            }
+            r.limbs[0] = static_cast<uint32_t>(rest);
+        } else {
+            // restoring binary division, the bit shifted out of r means r >= b
+            for (size_t i = Bits; i-- > 0;) {
+                bool overflow = (r.limbs[N - 1] >> 31u) != 0;
+                r <<= 1;
+                r.limbs[0] |= (a.limbs[i / 32] >> (i % 32)) & 1u;
+                if (overflow || !less_unsigned(r, b)) {
+                    r -= b;
+                    q.limbs[i / 32] |= 1u << (i % 32);
+                }
+            }
+        }
+
+        if (quotient_negative) {
+            q = -q;
+        }
+        if (remainder_negative) {
+            r = -r;
+        }
+    }
+};
+
+template <size_t Bits>
+using wide_uint = wide_integer<Bits, false>;
+
+template <size_t Bits>
+using wide_int = wide_integer<Bits, true>;
+
+#endif //BIGINT_WIDE_INTEGER_H
@@ -130,7 +130,7 @@ void big_integer::difference(big_integer &r, const big_integer &dq, size_t k, si
     size_t start = k;
     for (size_t i = 0; i <= m; i++) {
         uint64_t diff = (static_cast<uint64_t>(r.get_byte(start + i)) - dq.get_byte(i) - borrow);
-        borrow = (r.get_byte(start + i) < dq.get_byte(i) + borrow);
+        borrow = (diff >> 63u);
         r.num[start + i] = low32_bits_cast(diff);
     }
 }
@@ -209,8 +209,8 @@ big_integer& big_integer::operator%=(big_integer const& rhs) {
 }
 
 big_integer& big_integer::operator&=(big_integer const& rhs) {
-    negative &= rhs.negative;
     expand(rhs.length());
+    negative &= rhs.negative;
 
     for (size_t i = 0; i < length(); i++) {
         num[i] &= rhs.get_byte(i);
@@ -220,8 +220,8 @@ big_integer& big_integer::operator&=(big_integer const& rhs) {
 }
 
 big_integer& big_integer::operator|=(big_integer const& rhs) {
-    negative |= rhs.negative;
     expand(rhs.length());
+    negative |= rhs.negative;
 
     for (size_t i = 0; i < length(); i++) {
         num[i] |= rhs.get_byte(i);
@@ -231,8 +231,8 @@ big_integer& big_integer::operator|=(big_integer const& rhs) {
 }
 
 big_integer& big_integer::operator^=(big_integer const& rhs) {
-    negative ^= rhs.negative;
     expand(rhs.length());
+    negative ^= rhs.negative;
 
     for (size_t i = 0; i < length(); i++) {
         num[i] ^= rhs.get_byte(i);
@@ -384,12 +384,10 @@ bool operator<(big_integer const& a, big_integer const& b) {
         return a.negative;
     }
 
+    // equal lengths and signs: two's complement limbs order like unsigned ones
     for (int i = (int)a.length() - 1; i >= 0; i--) {
-        if (a.num[i] < b.num[i]) {
-            return !a.negative;
-        }
-        if (a.num[i] > b.num[i]) {
-            return a.negative;
+        if (a.num[i] != b.num[i]) {
+            return a.num[i] < b.num[i];
         }
     }
     return false;
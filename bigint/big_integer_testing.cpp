@@ -546,6 +546,25 @@ TEST(correctness, string_conv) {
   EXPECT_EQ("-1000000000000000", to_string(big_integer("-1000000000000000")));
 }
 
+TEST(correctness, div_all_ones_divisor) {
+  big_integer a("5983311767518815960376230064366644521178981914334273842965092379470");
+  big_integer b("170141183460469231731687303715884105727"); // 2^127 - 1
+  EXPECT_EQ(big_integer("35166745909634421014125728947"), a / b);
+  EXPECT_EQ(1, a % b);
+}
+
+TEST(correctness, compare_negative_same_length) {
+  EXPECT_TRUE(big_integer(-22731228) < big_integer(-5399947));
+  EXPECT_FALSE(big_integer(-5399947) < big_integer(-22731228));
+}
+
+TEST(correctness, bitwise_negative_shorter) {
+  big_integer mask = (big_integer(1) << 128) - 1;
+  EXPECT_EQ(mask - 4, big_integer(-5) & mask);
+  EXPECT_EQ(big_integer(-1), big_integer(-5) | mask << 1 | 1);
+  EXPECT_EQ(-mask - 1 + 4, big_integer(-5) ^ mask);
+}
+
 namespace {
 size_t const number_of_iterations = 10;
 size_t const max_size = 2048;
@@ -0,0 +1,86 @@
+#ifndef ALIGNED_ALLOCATOR_H
+#define ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <sys/mman.h>
+
+#include "vector.h"
+
+size_t const huge_page_size = 2 << 20;
+
+// allocator handing out Alignment-aligned blocks; with HugePages, blocks of at least a huge
+// page are aligned to it and marked MADV_HUGEPAGE so that the kernel can back them by
+// transparent huge pages
+template <typename T, size_t Alignment = 64, bool HugePages = false>
+struct aligned_allocator {
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "alignment must be a power of two");
+    static_assert(Alignment % sizeof(void*) == 0, "alignment must be a multiple of sizeof(void*)");
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = aligned_allocator<U, Alignment, HugePages>;
+    };
+
+    aligned_allocator() = default;
+
+    template <typename U>
+    aligned_allocator(aligned_allocator<U, Alignment, HugePages> const&) {}
+
+    T* allocate(size_t size) {
+        size_t bytes = size * sizeof(T);
+        size_t alignment = Alignment < alignof(T) ? alignof(T) : Alignment;
+        bool huge = HugePages && bytes >= huge_page_size;
+        if (huge) {
+            alignment = huge_page_size;
+            bytes = (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+        }
+
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, alignment, bytes) != 0) {
+            throw std::bad_alloc();
+        }
+        if (huge) {
+            madvise(ptr, bytes, MADV_HUGEPAGE);
+        }
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, size_t) {
+        free(ptr);
+    }
+
+    friend bool operator==(aligned_allocator const&, aligned_allocator const&) {
+        return true;
+    }
+
+    friend bool operator!=(aligned_allocator const&, aligned_allocator const&) {
+        return false;
+    }
+};
+
+template <typename T, size_t Alignment = 64>
+using aligned_vector = vector<T, aligned_allocator<T, Alignment> >;
+
+// grows like Growth, rounding capacities of a huge page or more up to whole huge pages
+template <typename Growth = doubling_growth>
+struct huge_page_growth {
+    static bool const auto_shrink = Growth::auto_shrink;
+
+    static size_t next_capacity(size_t capacity, size_t element_size) {
+        size_t next = Growth::next_capacity(capacity, element_size);
+        if (next * element_size < huge_page_size) {
+            return next;
+        }
+        return page_growth<Growth, huge_page_size>::next_capacity(capacity, element_size);
+    }
+};
+
+template <typename T, size_t Alignment = 64>
+using huge_page_vector = vector<T, aligned_allocator<T, Alignment, true>, huge_page_growth<> >;
+
+#endif // ALIGNED_ALLOCATOR_H
@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "vector.h"
+#include "segmented_vector.h"
+#include "aligned_allocator.h"
+#include "concurrent_vector.h"
+
+namespace {
+template<typename F>
+double measure(F const& f, size_t repetitions) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i != repetitions; ++i)
+    f();
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / repetitions;
+}
+
+size_t const N = 1 << 20;
+size_t const repetitions = 10;
+
+// 256 bytes that are expensive to copy and cheap to move
+struct heavy {
+  heavy() : payload(new uint64_t[32]()) {}
+
+  heavy(heavy const& other) : payload(new uint64_t[32]) {
+    std::copy(other.payload.get(), other.payload.get() + 32, payload.get());
+  }
+
+  heavy(heavy&& other) noexcept = default;
+
+  heavy& operator=(heavy const& other) {
+    heavy tmp(other);
+    payload.swap(tmp.payload);
+    return *this;
+  }
+
+  heavy& operator=(heavy&& other) noexcept = default;
+
+  std::unique_ptr<uint64_t[]> payload;
+};
+
+template<typename V, typename T>
+void push_back(T const& value) {
+  V v;
+  for (size_t i = 0; i != N; ++i)
+    v.push_back(value);
+}
+
+template<typename V, typename T>
+void push_back_reserved(T const& value) {
+  V v;
+  v.reserve(N);
+  for (size_t i = 0; i != N; ++i)
+    v.push_back(value);
+}
+
+// a full buffer regrown one element at a time
+template<typename V, typename T>
+void reserve_growth(T const& value) {
+  V v;
+  v.reserve(1024);
+  for (size_t i = 0; i != 1024; ++i)
+    v.push_back(value);
+  for (size_t c = 1025; c != 2048; ++c)
+    v.reserve(c);
+}
+
+// inserts and then erases one element at a time at the given fraction of the size
+template<typename V, typename T>
+void insert_erase(T const& value, size_t num, size_t den) {
+  V v;
+  for (size_t i = 0; i != (1 << 14); ++i)
+    v.insert(v.begin() + v.size() * num / den, value);
+  while (!v.empty())
+    v.erase(v.begin() + (v.size() - 1) * num / den);
+}
+
+template<typename V>
+void copy_vector(V const& v) {
+  V w = v;
+  if (w.size() != v.size())
+    std::abort();
+}
+
+template<typename V>
+void swap_vectors(V& a, V& b) {
+  for (size_t i = 0; i != N; ++i)
+    a.swap(b);
+}
+
+// something that depends on what the element owns, not only on its own bytes
+size_t contents(uint32_t x) {
+  return x;
+}
+
+size_t contents(std::string const& x) {
+  return x.size() + (x.empty() ? 0 : static_cast<unsigned char>(x[0]));
+}
+
+size_t contents(heavy const& x) {
+  return x.payload ? x.payload[0] + 1 : 0;
+}
+
+template<typename V>
+size_t iterate(V const& v) {
+  size_t count = 0;
+  for (auto const& x : v)
+    count += contents(x);
+  return count;
+}
+
+// push_back throughput, reallocation count and the capacity overhead averaged over
+// final sizes spread across [N / 2, N)
+template<typename Growth>
+void bench_growth(char const* name) {
+  using V = vector<uint32_t, std::allocator<uint32_t>, Growth>;
+  double ms = measure([] {
+    V v;
+    for (size_t i = 0; i != N; ++i)
+      v.push_back(static_cast<uint32_t>(i));
+  }, repetitions);
+
+  size_t reallocations = 0;
+  double overhead = 0;
+  size_t const samples = 64;
+  V v;
+  for (size_t s = 0; s != samples; ++s) {
+    size_t target = N / 2 + s * (N / 2 / samples);
+    for (size_t c = v.capacity(); v.size() != target; ) {
+      v.push_back(0);
+      if (v.capacity() != c) {
+        c = v.capacity();
+        ++reallocations;
+      }
+    }
+    overhead += static_cast<double>(v.capacity() - v.size()) / v.size();
+  }
+  std::printf("%-14s %12.3f %12zu %11.1f%%\n", name, ms, reallocations, 100 * overhead / samples);
+}
+
+// appending chunks never relocates, the sum shows what indexing through the chunk table costs
+template<typename V>
+void bench_segments(char const* name) {
+  V v;
+  double push = measure([&] {
+    V w;
+    for (size_t i = 0; i != 8 * N; ++i)
+      w.push_back(static_cast<uint32_t>(i));
+    v.swap(w);
+  }, repetitions);
+
+  uint64_t sum = 0;
+  double index = measure([&] {
+    for (size_t i = 0; i != v.size(); ++i)
+      sum += v[i];
+  }, repetitions);
+  double iterate = measure([&] {
+    for (uint32_t x : v)
+      sum += x;
+  }, repetitions);
+  std::printf("%-14s %12.3f %12.3f %12.3f %s\n", name, push, index, iterate, sum == 0 ? "!" : "");
+}
+
+// 256 MiB of uint64_t read in order and at random; the random walk is a TLB miss per access
+// unless the buffer is backed by huge pages
+template<typename V>
+void bench_pages(char const* name) {
+  size_t const size = size_t(1) << 25;
+  V v;
+  for (size_t i = 0; i != size; ++i)
+    v.push_back(i);
+
+  uint64_t sum = 0;
+  double stream = measure([&] {
+    for (size_t i = 0; i != size; ++i)
+      sum += v[i];
+  }, repetitions);
+  double random = measure([&] {
+    uint64_t x = 1;
+    for (size_t i = 0; i != size / 8; ++i) {
+      x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+      sum += v[(x >> 20) & (size - 1)];
+    }
+  }, 1);
+  double gb = size * sizeof(uint64_t) / 1e6;
+  std::printf("%-14s %12.2f %12.2f %s\n", name, gb / stream, size / 8 / random / 1e3, sum == 0 ? "!" : "");
+}
+
+void row(char const* name, std::function<void()> const& ours, std::function<void()> const& theirs,
+         size_t repetitions) {
+  double a = measure(ours, repetitions);
+  double b = measure(theirs, repetitions);
+  std::printf("%-12s %14.3f %14.3f %9.2fx\n", name, a, b, b / a);
+}
+
+// 8N appends split between the threads, into one vector behind a mutex and into a concurrent_vector
+template<typename F>
+double append_threads(size_t threads, F const& append) {
+  return measure([&] {
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t != threads; ++t)
+      workers.emplace_back([&, t] {
+        for (size_t i = t; i < 8 * N; i += threads)
+          append(static_cast<uint32_t>(i));
+      });
+    for (auto& w : workers)
+      w.join();
+  }, 1);
+}
+
+void bench_concurrent() {
+  std::printf("%-12s %14s %14s %10s\n", "threads", "mutex, M/s", "concurrent, M/s", "speedup");
+  for (size_t threads = 1; threads <= 8; threads *= 2) {
+    vector<uint32_t> locked;
+    std::mutex m;
+    double a = append_threads(threads, [&](uint32_t x) {
+      std::lock_guard<std::mutex> lock(m);
+      locked.push_back(x);
+    });
+    concurrent_vector<uint32_t> shared;
+    double b = append_threads(threads, [&](uint32_t x) { shared.push_back(x); });
+    std::printf("%-12zu %14.1f %14.1f %9.2fx\n", threads, 8 * N / a / 1e3, 8 * N / b / 1e3, a / b);
+  }
+}
+
+// 256 MiB copied and filled, both split across the hardware threads by vector
+void bench_bulk() {
+  size_t const size = size_t(1) << 25;
+  vector<uint64_t> ours(size, 1);
+  std::vector<uint64_t> theirs(size, 1);
+  std::printf("%-12s %14s %14s %10s\n", "bulk", "vector, ms", "std::vector, ms", "speedup");
+  row("copy", [&] { copy_vector(ours); }, [&] { copy_vector(theirs); }, repetitions);
+  row("assign", [&] { vector<uint64_t> v; v.assign(size, 2); }, [&] { std::vector<uint64_t> v; v.assign(size, 2); },
+      repetitions);
+}
+
+template<typename T>
+void bench_type(char const* name, T const& value) {
+  using V = vector<T>;
+  using S = std::vector<T>;
+  std::printf("%-12s %14s %14s %10s\n", name, "vector, ms", "std::vector, ms", "speedup");
+  row("push_back", [&] { push_back<V>(value); }, [&] { push_back<S>(value); }, repetitions);
+  row("reserved", [&] { push_back_reserved<V>(value); }, [&] { push_back_reserved<S>(value); }, repetitions);
+  row("reserve", [&] { reserve_growth<V>(value); }, [&] { reserve_growth<S>(value); }, repetitions);
+  row("front", [&] { insert_erase<V>(value, 0, 1); }, [&] { insert_erase<S>(value, 0, 1); }, 1);
+  row("middle", [&] { insert_erase<V>(value, 1, 2); }, [&] { insert_erase<S>(value, 1, 2); }, 1);
+  row("back", [&] { insert_erase<V>(value, 1, 1); }, [&] { insert_erase<S>(value, 1, 1); }, repetitions);
+
+  V ours;
+  S theirs;
+  for (size_t i = 0; i != N / 4; ++i) {
+    ours.push_back(value);
+    theirs.push_back(value);
+  }
+  V ours_other = ours;
+  S theirs_other = theirs;
+  size_t sink = 0;
+  row("copy", [&] { copy_vector(ours); }, [&] { copy_vector(theirs); }, repetitions);
+  row("swap", [&] { swap_vectors(ours, ours_other); }, [&] { swap_vectors(theirs, theirs_other); }, repetitions);
+  row("iterate", [&] { sink += iterate(ours); }, [&] { sink += iterate(theirs); }, repetitions);
+  if (sink == 0)
+    std::abort();
+}
+}
+
+int main() {
+  std::printf("%-14s %12s %12s %12s\n", "growth", "push, ms", "reallocs", "unused");
+  bench_growth<doubling_growth>("2x");
+  bench_growth<factor_growth<3, 2>>("1.5x");
+  bench_growth<page_growth<>>("2x pages");
+  bench_growth<capped_growth<(1 << 20)>>("capped 1 MiB");
+  std::printf("%-14s %12s %12s %12s\n", "container", "push, ms", "index, ms", "iterate, ms");
+  bench_segments<vector<uint32_t>>("vector");
+  bench_segments<segmented_vector<uint32_t>>("segmented");
+  std::printf("%-14s %12s %12s\n", "allocation", "stream, GB/s", "random, M/s");
+  bench_pages<vector<uint64_t>>("malloc");
+  bench_pages<aligned_vector<uint64_t>>("64-byte");
+  bench_pages<huge_page_vector<uint64_t>>("huge pages");
+  bench_concurrent();
+  bench_bulk();
+  bench_type<uint32_t>("uint32_t", 42);
+  bench_type<std::string>("std::string", std::string(1000, 'x'));
+  bench_type<heavy>("heavy", heavy());
+  return 0;
+}
@@ -0,0 +1,262 @@
+#ifndef CONCURRENT_VECTOR_H
+#define CONCURRENT_VECTOR_H
+
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// vector<T> that any number of threads may append to and read from at once. Storage is a
+// fixed table of segments, segment k > 0 holding Base << (k - 1) elements, so growth
+// allocates a new segment and never moves an element. A push_back claims its slot with a
+// compare-and-swap once the slot's segment exists, so a failed allocation never leaves a
+// claimed slot empty. size() is the length of the prefix of finished slots; whichever writer
+// finds the slot at size() finished moves size() past it, so no writer waits for another.
+// Moving T must not throw, the copy made by push_back happens before the slot is claimed
+template <typename T, typename Allocator = std::allocator<T>, size_t Base = 64>
+struct concurrent_vector {
+    static_assert(Base != 0 && (Base & (Base - 1)) == 0, "the first segment must be a power of two");
+    static_assert(std::is_nothrow_move_constructible<T>::value, "a reserved slot must always be filled");
+
+    using allocator_type = Allocator;
+
+    concurrent_vector();                            // O(1) nothrow
+    explicit concurrent_vector(Allocator const&);   // O(1) nothrow
+    concurrent_vector(concurrent_vector const&) = delete;
+    concurrent_vector& operator=(concurrent_vector const&) = delete;
+
+    ~concurrent_vector();                           // O(N) nothrow, not concurrent
+
+    allocator_type get_allocator() const;           // O(1) nothrow
+
+    T& operator[](size_t i);                        // O(1) nothrow, i < size()
+    T const& operator[](size_t i) const;            // O(1) nothrow, i < size()
+
+    size_t size() const;                            // O(1) nothrow
+    bool empty() const;                             // O(1) nothrow
+
+    T& push_back(T const&);                         // O(1) strong, thread-safe
+    T& push_back(T&&);                              // O(1) strong, thread-safe
+    template <typename... Args>
+    T& emplace_back(Args&&... args);                // O(1) strong, thread-safe
+
+    size_t capacity() const;                        // O(1) nothrow
+    void reserve(size_t);                           // O(log N) strong, thread-safe
+
+    void clear();                                   // O(N) nothrow, not concurrent, keeps the segments
+
+private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+    struct cell {
+        cell()
+            : ready(false) {}
+
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type value;
+        std::atomic<bool> ready;
+    };
+
+    using cell_allocator = typename alloc_traits::template rebind_alloc<cell>;
+    using cell_traits = std::allocator_traits<cell_allocator>;
+
+    static size_t const segments = 65 - __builtin_ctzll(Base);
+
+    static size_t segment_of(size_t i);
+    static size_t segment_begin(size_t segment);
+    static size_t segment_size(size_t segment);
+
+    cell* slot(size_t i) const;
+    cell* segment(size_t segment);
+    void publish();
+
+private:
+    Allocator alloc_;
+    std::atomic<cell*> table_[segments];
+    std::atomic<bool> allocating_[segments];
+    std::atomic<size_t> reserved_;
+    std::atomic<size_t> size_;
+};
+
+template <typename T, typename Allocator, size_t Base>
+concurrent_vector<T, Allocator, Base>::concurrent_vector()
+    : concurrent_vector(Allocator()) {}
+
+template <typename T, typename Allocator, size_t Base>
+concurrent_vector<T, Allocator, Base>::concurrent_vector(Allocator const& alloc)
+    : alloc_(alloc)
+    , reserved_(0)
+    , size_(0) {
+    for (size_t k = 0; k < segments; k++) {
+        table_[k].store(nullptr, std::memory_order_relaxed);
+        allocating_[k].store(false, std::memory_order_relaxed);
+    }
+}
+
+template <typename T, typename Allocator, size_t Base>
+concurrent_vector<T, Allocator, Base>::~concurrent_vector() {
+    clear();
+    for (size_t k = 0; k < segments; k++) {
+        cell* ptr = table_[k].load(std::memory_order_relaxed);
+        if (ptr != nullptr) {
+            cell_allocator alloc(alloc_);
+            for (size_t i = 0; i < segment_size(k); i++) {
+                cell_traits::destroy(alloc, ptr + i);
+            }
+            cell_traits::deallocate(alloc, ptr, segment_size(k));
+        }
+    }
+}
+
+template <typename T, typename Allocator, size_t Base>
+typename concurrent_vector<T, Allocator, Base>::allocator_type
+concurrent_vector<T, Allocator, Base>::get_allocator() const {
+    return alloc_;
+}
+
+template <typename T, typename Allocator, size_t Base>
+T& concurrent_vector<T, Allocator, Base>::operator[](size_t i) {
+    return reinterpret_cast<T&>(slot(i)->value);
+}
+
+template <typename T, typename Allocator, size_t Base>
+T const& concurrent_vector<T, Allocator, Base>::operator[](size_t i) const {
+    return reinterpret_cast<T const&>(slot(i)->value);
+}
+
+// acquire pairs with the release in publish, everything below size() is fully constructed
+template <typename T, typename Allocator, size_t Base>
+size_t concurrent_vector<T, Allocator, Base>::size() const {
+    return size_.load(std::memory_order_acquire);
+}
+
+template <typename T, typename Allocator, size_t Base>
+bool concurrent_vector<T, Allocator, Base>::empty() const {
+    return size() == 0;
+}
+
+template <typename T, typename Allocator, size_t Base>
+T& concurrent_vector<T, Allocator, Base>::push_back(T const& value) {
+    return emplace_back(value);
+}
+
+template <typename T, typename Allocator, size_t Base>
+T& concurrent_vector<T, Allocator, Base>::push_back(T&& value) {
+    return emplace_back(std::move(value));
+}
+
+// everything that may throw happens before the slot is reserved
+template <typename T, typename Allocator, size_t Base>
+template <typename... Args>
+T& concurrent_vector<T, Allocator, Base>::emplace_back(Args&&... args) {
+    T value(std::forward<Args>(args)...);
+
+    size_t i = reserved_.load(std::memory_order_relaxed);
+    cell* c;
+    do {
+        c = segment(segment_of(i)) + (i - segment_begin(segment_of(i)));
+    } while (!reserved_.compare_exchange_weak(i, i + 1));
+    T* ptr = reinterpret_cast<T*>(&c->value);
+    alloc_traits::construct(alloc_, ptr, std::move(value));
+    c->ready.store(true);
+    publish();
+    return *ptr;
+}
+
+template <typename T, typename Allocator, size_t Base>
+size_t concurrent_vector<T, Allocator, Base>::capacity() const {
+    size_t k = 0;
+    while (k < segments && table_[k].load(std::memory_order_acquire) != nullptr) {
+        k++;
+    }
+    return segment_begin(k);
+}
+
+template <typename T, typename Allocator, size_t Base>
+void concurrent_vector<T, Allocator, Base>::reserve(size_t new_capacity) {
+    if (new_capacity == 0) {
+        return;
+    }
+    for (size_t k = 0, last = segment_of(new_capacity - 1); k <= last; k++) {
+        segment(k);
+    }
+}
+
+template <typename T, typename Allocator, size_t Base>
+void concurrent_vector<T, Allocator, Base>::clear() {
+    size_t size = size_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < size; i++) {
+        alloc_traits::destroy(alloc_, &(*this)[i]);
+        slot(i)->ready.store(false, std::memory_order_relaxed);
+    }
+    reserved_.store(0, std::memory_order_relaxed);
+    size_.store(0, std::memory_order_relaxed);
+}
+
+template <typename T, typename Allocator, size_t Base>
+size_t concurrent_vector<T, Allocator, Base>::segment_of(size_t i) {
+    return i < Base ? 0 : 64 - __builtin_clzll(i / Base);
+}
+
+template <typename T, typename Allocator, size_t Base>
+size_t concurrent_vector<T, Allocator, Base>::segment_begin(size_t segment) {
+    return segment == 0 ? 0 : Base << (segment - 1);
+}
+
+template <typename T, typename Allocator, size_t Base>
+size_t concurrent_vector<T, Allocator, Base>::segment_size(size_t segment) {
+    return segment == 0 ? Base : Base << (segment - 1);
+}
+
+template <typename T, typename Allocator, size_t Base>
+typename concurrent_vector<T, Allocator, Base>::cell* concurrent_vector<T, Allocator, Base>::slot(size_t i) const {
+    size_t k = segment_of(i);
+    return table_[k].load(std::memory_order_acquire) + (i - segment_begin(k));
+}
+
+// only the thread that wins allocating_[k] allocates the segment, the others yield until it
+// is installed; a failed allocation releases the flag so that the next caller retries
+template <typename T, typename Allocator, size_t Base>
+typename concurrent_vector<T, Allocator, Base>::cell* concurrent_vector<T, Allocator, Base>::segment(size_t k) {
+    for (;;) {
+        cell* ptr = table_[k].load(std::memory_order_acquire);
+        if (ptr != nullptr) {
+            return ptr;
+        }
+        bool expected = false;
+        if (!allocating_[k].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        cell_allocator alloc(alloc_);
+        cell* fresh;
+        try {
+            fresh = cell_traits::allocate(alloc, segment_size(k));
+        } catch (...) {
+            allocating_[k].store(false, std::memory_order_release);
+            throw;
+        }
+        for (size_t i = 0; i < segment_size(k); i++) {
+            cell_traits::construct(alloc, fresh + i);
+        }
+        table_[k].store(fresh, std::memory_order_release);
+        return fresh;
+    }
+}
+
+// called once a slot is ready; moves size() over every ready slot it finds. Either this
+// thread sees size() reach its slot or the thread that moves it there sees the slot ready, both
+// sides being sequentially consistent. Claimed slots always have their segment
+template <typename T, typename Allocator, size_t Base>
+void concurrent_vector<T, Allocator, Base>::publish() {
+    size_t size = size_.load();
+    while (size < reserved_.load() && slot(size)->ready.load()) {
+        if (size_.compare_exchange_weak(size, size + 1)) {
+            size++;
+        }
+    }
+}
+
+#endif // CONCURRENT_VECTOR_H
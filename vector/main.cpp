@@ -1,10 +1,43 @@
 #include "vector.h"
+#include "small_vector.h"
+#include "segmented_vector.h"
+#include "mmap_vector.h"
+#include "aligned_allocator.h"
+#include "concurrent_vector.h"
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <unordered_set>
+#include <vector>
+#include <unistd.h>
 
 template
 struct vector<int>;
 
+template
+struct vector<int, std::allocator<int>, shrinking<page_growth<factor_growth<3, 2> > > >;
+
+template
+struct small_vector<int, 4>;
+
+template
+struct segmented_vector<int>;
+
+template
+struct mmap_vector<int>;
+
+template
+struct vector<int, aligned_allocator<int, 64, true>, huge_page_growth<> >;
+
+template
+struct concurrent_vector<int>;
+
 template<typename T>
 T const& as_const(T& obj) {
   return obj;
@@ -322,6 +355,73 @@ TEST(correctness, insert_end) {
   element<size_t>::expect_no_instances();
 }
 
+TEST(correctness, insert_count) {
+  size_t const N = 50;
+  for (size_t count : {0u, 3u, 20u, 100u}) {
+    for (size_t pos : {0u, 10u, 50u}) {
+      {
+        vector<element<size_t> > a;
+        a.reserve(200);
+        for (size_t i = 0; i != N; ++i) a.push_back(i);
+
+        a.insert(a.begin() + pos, count, a[N - 1]);
+        EXPECT_EQ(N + count, a.size());
+        for (size_t i = 0; i != N + count; ++i) {
+          if (i < pos)
+            EXPECT_EQ(i, a[i]);
+          else if (i < pos + count)
+            EXPECT_EQ(N - 1, a[i]);
+          else
+            EXPECT_EQ(i - count, a[i]);
+        }
+      }
+      element<size_t>::expect_no_instances();
+    }
+  }
+}
+
+TEST(correctness, insert_range) {
+  std::list<size_t> src = {7, 8, 9};
+  vector<element<size_t> > a;
+  for (size_t i = 0; i != 5; ++i) a.push_back(i);
+
+  a.insert(a.begin() + 2, src.begin(), src.end());
+  size_t const expected[] = {0, 1, 7, 8, 9, 2, 3, 4};
+  ASSERT_EQ(8, a.size());
+  for (size_t i = 0; i != 8; ++i) EXPECT_EQ(expected[i], a[i]);
+
+  std::istringstream in("5 6");
+  vector<int> b;
+  b.push_back(1);
+  b.insert(b.begin(), std::istream_iterator<int>(in), std::istream_iterator<int>());
+  ASSERT_EQ(3, b.size());
+  EXPECT_EQ(5, b[0]);
+  EXPECT_EQ(6, b[1]);
+  EXPECT_EQ(1, b[2]);
+
+  b.insert(b.end(), 2, 4);
+  EXPECT_EQ(5, b.size());
+  EXPECT_EQ(4, b.back());
+}
+
+TEST(correctness, insert_throw) {
+  size_t const N = 10;
+  {
+    vector<element<size_t> > a;
+    a.reserve(N);
+    for (size_t i = 0; i != N; ++i) a.push_back(i);
+    element<size_t>::set_throw_countdown(5);
+    EXPECT_THROW(a.insert(a.begin() + 3, 4, element<size_t>(42)), std::runtime_error);
+    EXPECT_EQ(N, a.size());
+    for (size_t i = 0; i != N; ++i) EXPECT_EQ(i, a[i]);
+
+    a.reserve(2 * N);
+    element<size_t>::set_throw_countdown(3);
+    EXPECT_THROW(a.insert(a.begin() + 3, 4, element<size_t>(42)), std::runtime_error);
+  }
+  element<size_t>::expect_no_instances();
+}
+
 TEST(correctness, erase) {
   size_t const N = 500;
   {
@@ -451,6 +551,302 @@ TEST(correctness, reallocation_throw) {
   element<size_t>::expect_no_instances();
 }
 
+namespace {
+// stateful allocator counting live blocks per id
+template<typename T, bool Propagate>
+struct tracking_allocator {
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::integral_constant<bool, Propagate>;
+  using propagate_on_container_move_assignment = std::integral_constant<bool, Propagate>;
+  using propagate_on_container_swap = std::integral_constant<bool, Propagate>;
+
+  explicit tracking_allocator(int id) : id(id) {}
+
+  template<typename U>
+  tracking_allocator(tracking_allocator<U, Propagate> const& other) : id(other.id) {}
+
+  T* allocate(size_t n) {
+    ++live()[id];
+    return static_cast<T*>(operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, size_t) {
+    --live()[id];
+    operator delete(p);
+  }
+
+  tracking_allocator select_on_container_copy_construction() const {
+    return tracking_allocator(id + 100);
+  }
+
+  static std::map<int, int>& live() {
+    static std::map<int, int> blocks;
+    return blocks;
+  }
+
+  friend bool operator==(tracking_allocator const& a, tracking_allocator const& b) {
+    return a.id == b.id;
+  }
+
+  friend bool operator!=(tracking_allocator const& a, tracking_allocator const& b) {
+    return a.id != b.id;
+  }
+
+  int id;
+};
+}
+
+TEST(correctness, allocator_propagation) {
+  using propagating = tracking_allocator<element<size_t>, true>;
+  using fixed = tracking_allocator<element<size_t>, false>;
+  {
+    vector<element<size_t>, propagating> a(propagating(1));
+    for (size_t i = 0; i != 100; ++i) a.push_back(i);
+    EXPECT_EQ(1, propagating::live()[1]);
+
+    vector<element<size_t>, propagating> b = a;
+    EXPECT_EQ(101, b.get_allocator().id);
+
+    vector<element<size_t>, propagating> c(propagating(2));
+    c.push_back(7);
+    c = a;
+    EXPECT_EQ(1, c.get_allocator().id);
+    EXPECT_EQ(0, propagating::live()[2]);
+
+    vector<element<size_t>, fixed> d(fixed(3)), e(fixed(4));
+    d.push_back(1);
+    e.push_back(2);
+    e = d;
+    EXPECT_EQ(4, e.get_allocator().id);
+    e = std::move(d);
+    EXPECT_EQ(4, e.get_allocator().id);
+    EXPECT_EQ(1, e[0]);
+
+    c.swap(a);
+    EXPECT_EQ(1, c.get_allocator().id);
+  }
+  EXPECT_EQ(0, propagating::live()[1]);
+  EXPECT_EQ(0, propagating::live()[101]);
+  EXPECT_EQ(0, fixed::live()[3]);
+  EXPECT_EQ(0, fixed::live()[4]);
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, allocator_reallocation_throw) {
+  using fixed = tracking_allocator<element<size_t>, false>;
+  {
+    vector<element<size_t>, fixed> a(fixed(5));
+    a.reserve(10);
+    size_t n = a.capacity();
+    for (size_t i = 0; i != n; ++i) a.push_back(i);
+    element<size_t>::set_throw_countdown(7);
+    EXPECT_THROW(a.push_back(42), std::runtime_error);
+    EXPECT_EQ(n, a.size());
+    EXPECT_EQ(1, fixed::live()[5]);
+  }
+  EXPECT_EQ(0, fixed::live()[5]);
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, move) {
+  size_t const N = 500;
+  {
+    vector<element<size_t> > a;
+    for (size_t i = 0; i != N; ++i) a.push_back(i);
+    element<size_t>* old_data = a.data();
+
+    vector<element<size_t> > b = std::move(a);
+    EXPECT_EQ(old_data, b.data());
+    EXPECT_TRUE(a.empty());
+
+    a = std::move(b);
+    EXPECT_EQ(old_data, a.data());
+    EXPECT_EQ(N, a.size());
+  }
+  element<size_t>::expect_no_instances();
+}
+
+namespace {
+struct movable {
+  movable(size_t val) : val(val) {}
+  movable(movable const& rhs) : val(rhs.val) { ++copies; }
+  movable(movable&& rhs) noexcept : val(rhs.val) { ++moves; }
+
+  size_t val;
+  static size_t copies;
+  static size_t moves;
+};
+
+size_t movable::copies = 0;
+size_t movable::moves = 0;
+}
+
+TEST(correctness, reallocation_moves) {
+  size_t const N = 500;
+  vector<movable> a;
+  for (size_t i = 0; i != N; ++i) a.push_back(i);
+  EXPECT_EQ(0u, movable::copies);
+  EXPECT_LT(0u, movable::moves);
+  for (size_t i = 0; i != N; ++i) EXPECT_EQ(i, a[i].val);
+
+  vector<movable> b = a;
+  EXPECT_EQ(N, movable::copies);
+}
+
+TEST(correctness, emplace_back) {
+  size_t const N = 500;
+  {
+    vector<element<size_t> > a;
+    for (size_t i = 0; i != N; ++i) EXPECT_EQ(i, a.emplace_back(i));
+    for (size_t i = 0; i != N; ++i) a.emplace_back(a[i]);
+
+    ASSERT_EQ(2 * N, a.size());
+    for (size_t i = 0; i != 2 * N; ++i) EXPECT_EQ(i % N, a[i]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, emplace_back_throw) {
+  {
+    vector<element<size_t> > a;
+    a.reserve(10);
+    size_t n = a.capacity();
+    for (size_t i = 0; i != n; ++i) a.emplace_back(i);
+    element<size_t>* old_data = a.data();
+    element<size_t>::set_throw_countdown(4);
+    EXPECT_THROW(a.emplace_back(a[0]), std::runtime_error);
+    EXPECT_EQ(n, a.size());
+    EXPECT_EQ(old_data, a.data());
+    for (size_t i = 0; i != n; ++i) EXPECT_EQ(i, a[i]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, emplace) {
+  size_t const N = 100;
+  {
+    vector<element<size_t> > a;
+    for (size_t i = 0; i != N; ++i) a.emplace(a.begin(), i);
+    a.emplace(a.begin() + N / 2, a[0]);
+    a.emplace(a.end(), 7);
+
+    ASSERT_EQ(N + 2, a.size());
+    for (size_t i = 0; i != N / 2; ++i) EXPECT_EQ(N - 1 - i, a[i]);
+    EXPECT_EQ(N - 1, a[N / 2]);
+    for (size_t i = N / 2; i != N; ++i) EXPECT_EQ(N - 1 - i, a[i + 1]);
+    EXPECT_EQ(7, a.back());
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, push_back_rvalue) {
+  vector<std::string> a;
+  std::string s(100, 'x');
+  char const* buffer = s.data();
+  a.push_back(std::move(s));
+  EXPECT_EQ(buffer, a[0].data());
+}
+
+TEST(correctness, resize) {
+  size_t const N = 500;
+  {
+    vector<element<size_t> > a;
+    a.resize(N);
+    EXPECT_EQ(N, a.size());
+    for (size_t i = 0; i != N; ++i) a[i] = i;
+
+    a.resize(N / 2);
+    EXPECT_EQ(N / 2, a.size());
+
+    a.resize(2 * N, a[1]);
+    EXPECT_EQ(2 * N, a.size());
+    for (size_t i = 0; i != N / 2; ++i) EXPECT_EQ(i, a[i]);
+    for (size_t i = N / 2; i != 2 * N; ++i) EXPECT_EQ(1, a[i]);
+
+    a.resize(0);
+    EXPECT_TRUE(a.empty());
+  }
+  element<size_t>::expect_no_instances();
+
+  vector<int> b;
+  b.push_back(3);
+  b.resize(N);
+  EXPECT_EQ(3, b[0]);
+  for (size_t i = 1; i != N; ++i) EXPECT_EQ(0, b[i]);
+}
+
+TEST(correctness, resize_throw) {
+  {
+    vector<element<size_t> > a;
+    for (size_t i = 0; i != 10; ++i) a.push_back(i);
+    element<size_t>::set_throw_countdown(5);
+    EXPECT_THROW(a.resize(20, element<size_t>(42)), std::runtime_error);
+    EXPECT_EQ(10, a.size());
+    for (size_t i = 0; i != 10; ++i) EXPECT_EQ(i, a[i]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+namespace {
+template<typename V>
+std::vector<size_t> capacities(size_t n) {
+  std::vector<size_t> result;
+  V v;
+  for (size_t i = 0; i != n; ++i) {
+    v.push_back(0);
+    if (result.empty() || result.back() != v.capacity())
+      result.push_back(v.capacity());
+  }
+  return result;
+}
+}
+
+TEST(correctness, growth_policies) {
+  using by_half = vector<int, std::allocator<int>, factor_growth<3, 2> >;
+  using paged = vector<int, std::allocator<int>, page_growth<> >;
+  using capped = vector<int, std::allocator<int>, capped_growth<64> >;
+
+  EXPECT_EQ((std::vector<size_t>{1, 2, 3, 4, 6, 9, 13}), capacities<by_half>(10));
+  EXPECT_EQ((std::vector<size_t>{1024, 2048}), capacities<paged>(2000));
+  EXPECT_EQ((std::vector<size_t>{1, 2, 4, 8, 16, 32, 48}), capacities<capped>(40));
+
+  capped c;
+  c.resize(20);
+  EXPECT_EQ(20, c.capacity());
+}
+
+TEST(correctness, shrink_hysteresis) {
+  size_t const N = 1024;
+  vector<size_t, std::allocator<size_t>, shrinking<doubling_growth> > a;
+  for (size_t i = 0; i != N; ++i) a.push_back(i);
+  EXPECT_EQ(N, a.capacity());
+
+  while (a.size() != N / 4) a.pop_back();
+  EXPECT_EQ(N, a.capacity());
+  a.pop_back();
+  EXPECT_EQ(N / 2, a.capacity());
+  a.push_back(0);
+  EXPECT_EQ(N / 2, a.capacity());
+
+  a.erase(a.begin() + 1, a.end());
+  EXPECT_GE(4u, a.capacity());
+  EXPECT_EQ(0, a[0]);
+
+  vector<size_t> b;
+  for (size_t i = 0; i != N; ++i) b.push_back(i);
+  b.erase(b.begin(), b.end());
+  EXPECT_EQ(N, b.capacity());
+
+  // copying could throw, so such elements are never relocated behind the caller's back
+  {
+    vector<element<size_t>, std::allocator<element<size_t> >, shrinking<doubling_growth> > c;
+    for (size_t i = 0; i != N; ++i) c.push_back(i);
+    c.erase(c.begin(), c.end());
+    EXPECT_EQ(N, c.capacity());
+  }
+  element<size_t>::expect_no_instances();
+}
+
 TEST(correctness, empty_storage) {
   vector<int> a;
   EXPECT_EQ(nullptr, a.data());
@@ -468,3 +864,373 @@ TEST(correctness, empty_storage_shrink_to_fit) {
   a.shrink_to_fit();
   EXPECT_EQ(nullptr, a.data());
 }
+
+namespace {
+template<typename V>
+V small_range(size_t n, size_t from = 0) {
+  V a;
+  for (size_t i = 0; i != n; ++i) a.push_back(from + i);
+  return a;
+}
+
+template<typename V>
+void expect_range(V const& a, size_t n, size_t from = 0) {
+  ASSERT_EQ(n, a.size());
+  for (size_t i = 0; i != n; ++i) EXPECT_EQ(from + i, a[i]);
+}
+}
+
+TEST(correctness, small_vector_spill) {
+  typedef small_vector<element<size_t>, 4> small;
+  {
+    small a;
+    EXPECT_TRUE(a.is_inline());
+    EXPECT_EQ(4, a.capacity());
+    for (size_t i = 0; i != 4; ++i) a.push_back(i);
+    EXPECT_TRUE(a.is_inline());
+    a.push_back(a[0]);
+    EXPECT_FALSE(a.is_inline());
+    EXPECT_EQ(0, a[4]);
+
+    a.insert(a.begin() + 1, 2, 42);
+    a.erase(a.begin() + 3, a.end());
+    EXPECT_EQ(0, a[0]);
+    EXPECT_EQ(42, a[1]);
+    EXPECT_EQ(42, a[2]);
+    a.shrink_to_fit();
+    EXPECT_TRUE(a.is_inline());
+    EXPECT_EQ(3, a.size());
+    EXPECT_EQ(42, a[2]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, small_vector_move_swap) {
+  typedef small_vector<element<size_t>, 4> small;
+  size_t const sizes[] = {0, 3, 4, 10};
+  for (size_t n : sizes) {
+    for (size_t m : sizes) {
+      {
+        small a = small_range<small>(n);
+        small b = small_range<small>(m, 100);
+        a.swap(b);
+        expect_range(a, m, 100);
+        expect_range(b, n);
+        EXPECT_EQ(m <= 4, a.is_inline());
+        EXPECT_EQ(n <= 4, b.is_inline());
+
+        small c(std::move(a));
+        expect_range(c, m, 100);
+        EXPECT_TRUE(a.empty());
+        EXPECT_TRUE(a.is_inline());
+
+        b = std::move(c);
+        expect_range(b, m, 100);
+        b = b;
+        expect_range(b, m, 100);
+        c = b;
+        expect_range(c, m, 100);
+        c.push_back(0);
+        EXPECT_EQ(m + 1, c.size());
+      }
+      element<size_t>::expect_no_instances();
+    }
+  }
+}
+
+TEST(correctness, small_vector_throw) {
+  typedef small_vector<element<size_t>, 4> small;
+  {
+    small a = small_range<small>(4);
+    element<size_t>::set_throw_countdown(3);
+    EXPECT_THROW(a.push_back(4), std::runtime_error);
+    expect_range(a, 4);
+    EXPECT_TRUE(a.is_inline());
+
+    small b = small_range<small>(2, 100);
+    element<size_t>::set_throw_countdown(3);
+    EXPECT_THROW(b = a, std::runtime_error);
+    expect_range(b, 2, 100);
+
+    element<size_t>::set_throw_countdown(2);
+    EXPECT_THROW(b.insert(b.begin(), a.begin(), a.end()), std::runtime_error);
+    expect_range(b, 2, 100);
+    element<size_t>::set_throw_countdown(0);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, small_vector_erase_empty_range) {
+  typedef small_vector<std::vector<int>, 4> small;
+  static_assert(std::is_nothrow_move_constructible<small>::value, "small_vector must relocate by moving");
+  for (size_t n : {3, 6}) {
+    small a;
+    for (size_t i = 0; i != n; ++i) a.push_back(std::vector<int>(i + 1, 7));
+    EXPECT_EQ(a.begin() + 1, a.erase(a.begin() + 1, a.begin() + 1));
+    EXPECT_EQ(a.end(), a.erase(a.end(), a.end()));
+    EXPECT_EQ(n, a.size());
+    for (size_t i = 0; i != n; ++i) EXPECT_EQ(i + 1, a[i].size());
+  }
+}
+
+TEST(correctness, segmented_vector_stable) {
+  typedef segmented_vector<element<size_t>, std::allocator<element<size_t> >, 4> segmented;
+  {
+    segmented a;
+    a.push_back(0);
+    element<size_t>* first = &a[0];
+    for (size_t i = 1; i != 100; ++i) a.push_back(a[i - 1]), a.back() = i;
+    EXPECT_EQ(first, &a[0]);
+    EXPECT_EQ(100, a.capacity());
+    expect_range(a, 100);
+    EXPECT_EQ(100, a.end() - a.begin());
+    EXPECT_EQ(42, a.begin()[42]);
+    EXPECT_EQ(99, *(a.cend() - 1));
+
+    a.resize(10);
+    a.shrink_to_fit();
+    EXPECT_EQ(12, a.capacity());
+    EXPECT_EQ(first, &a[0]);
+    a.resize(14, 7);
+    EXPECT_EQ(7, a[13]);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, segmented_vector_copy_move) {
+  typedef segmented_vector<element<size_t>, std::allocator<element<size_t> >, 4> segmented;
+  {
+    segmented a = small_range<segmented>(10);
+    segmented b = a;
+    expect_range(b, 10);
+    segmented c = small_range<segmented>(3, 100);
+    c = b;
+    expect_range(c, 10);
+
+    element<size_t>* p = &b[5];
+    segmented d(std::move(b));
+    EXPECT_EQ(p, &d[5]);
+    EXPECT_TRUE(b.empty());
+    c = std::move(d);
+    EXPECT_EQ(p, &c[5]);
+
+    a.swap(b);
+    EXPECT_TRUE(a.empty());
+    expect_range(b, 10);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, segmented_vector_throw) {
+  typedef segmented_vector<element<size_t>, std::allocator<element<size_t> >, 4> segmented;
+  {
+    segmented a = small_range<segmented>(6);
+    element<size_t>::set_throw_countdown(3);
+    EXPECT_THROW(segmented b = a, std::runtime_error);
+
+    segmented c = small_range<segmented>(2, 100);
+    element<size_t>::set_throw_countdown(3);
+    EXPECT_THROW(c = a, std::runtime_error);
+    expect_range(c, 2, 100);
+
+    element<size_t>::set_throw_countdown(4);
+    EXPECT_THROW(c.resize(10, 0), std::runtime_error);
+    expect_range(c, 2, 100);
+    element<size_t>::set_throw_countdown(0);
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, segmented_vector_iterators) {
+  segmented_vector<int, std::allocator<int>, 8> a;
+  for (int i = 0; i != 100; ++i) a.push_back((i * 37) % 100);
+  std::sort(a.begin(), a.end());
+  for (int i = 0; i != 100; ++i) EXPECT_EQ(i, a[i]);
+  EXPECT_EQ(a.end(), std::find(a.begin(), a.end(), 100));
+  EXPECT_EQ(50, std::lower_bound(a.cbegin(), a.cend(), 50) - a.cbegin());
+}
+
+namespace {
+struct temp_file {
+  temp_file() : path("mmap_vector_test_" + std::to_string(::getpid())) {
+    std::remove(path.c_str());
+  }
+
+  ~temp_file() {
+    std::remove(path.c_str());
+  }
+
+  std::string path;
+};
+}
+
+TEST(correctness, mmap_vector) {
+  temp_file file;
+  {
+    mmap_vector<uint64_t> a(file.path);
+    EXPECT_TRUE(a.empty());
+    for (uint64_t i = 0; i != 10000; ++i) a.push_back(i * i);
+    a.push_back(a[0]);
+    a.erase(a.begin(), a.begin() + 1);
+    a.insert(a.begin(), 0);
+    a.pop_back();
+    a.advise(mmap_vector<uint64_t>::access::sequential);
+    a.flush();
+  }
+  {
+    mmap_vector<uint64_t> a(file.path);
+    ASSERT_EQ(10000, a.size());
+    EXPECT_LE(10000, a.capacity());
+    for (uint64_t i = 0; i != 10000; ++i) EXPECT_EQ(i * i, a[i]);
+
+    a.resize(3);
+    a.shrink_to_fit();
+    EXPECT_EQ(3, a.capacity());
+    a.resize(5);
+    EXPECT_EQ(4, a[2]);
+    EXPECT_EQ(0, a[4]);
+
+    static_assert(std::is_nothrow_move_constructible<mmap_vector<uint64_t> >::value, "moves never fail");
+    mmap_vector<uint64_t> b(std::move(a));
+    EXPECT_EQ(5, b.size());
+    EXPECT_EQ(0, a.size());
+    EXPECT_TRUE(a.empty());
+    a.clear();
+
+    b[3] = 7;
+    b[4] = 8;
+    b.resize(3);
+    b.resize(b.capacity() + 2);
+    EXPECT_EQ(0, b[3]);
+    EXPECT_EQ(0, b[4]);
+    EXPECT_EQ(0, b[b.size() - 1]);
+  }
+  EXPECT_THROW(mmap_vector<uint32_t> c(file.path), std::runtime_error);
+  EXPECT_THROW(mmap_vector<int> d("/nonexistent/mmap_vector"), std::runtime_error);
+}
+
+TEST(correctness, aligned_allocation) {
+  aligned_vector<uint32_t> a;
+  for (uint32_t i = 0; i != 1000; ++i) {
+    a.push_back(i);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(a.data()) % 64);
+  }
+  aligned_vector<uint32_t, 4096> b;
+  b.insert(b.end(), a.begin(), a.end());
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(b.data()) % 4096);
+  EXPECT_EQ(999, b.back());
+
+  huge_page_vector<uint64_t> c;
+  c.push_back(1);
+  EXPECT_GT(huge_page_size / sizeof(uint64_t), c.capacity());
+  while (c.size() != huge_page_size / sizeof(uint64_t) + 1) c.push_back(0);
+  EXPECT_EQ(0, c.capacity() % (huge_page_size / sizeof(uint64_t)));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(c.data()) % huge_page_size);
+  EXPECT_EQ(1, c[0]);
+}
+
+namespace {
+// forces the parallel bulk paths for the lifetime of the guard, even on one CPU
+struct bulk_threads_guard {
+  explicit bulk_threads_guard(size_t threads) {
+    parallel_bulk_threads() = threads;
+  }
+
+  ~bulk_threads_guard() {
+    parallel_bulk_threads() = 0;
+  }
+};
+}
+
+TEST(correctness, parallel_bulk) {
+  bulk_threads_guard guard(4);
+  size_t const n = parallel_bulk_bytes / sizeof(size_t) * 2 + 7;
+
+  vector<size_t> a(n, 5);
+  EXPECT_EQ(n, a.size());
+  EXPECT_EQ(5, a[n - 1]);
+  for (size_t i = 0; i != n; ++i) a[i] = i;
+
+  vector<size_t> b = a;
+  EXPECT_EQ(n - 1, b[n - 1]);
+  EXPECT_EQ(n / 2, b[n / 2]);
+
+  b.assign(a.begin() + 1, a.end());
+  EXPECT_EQ(n - 1, b.size());
+  EXPECT_EQ(1, b[0]);
+  EXPECT_EQ(n - 1, b[n - 2]);
+  b.resize(2 * n);
+  EXPECT_EQ(0, b[n - 1]);
+  EXPECT_EQ(0, b[2 * n - 1]);
+  b.resize(3 * n, 3);
+  EXPECT_EQ(3, b[3 * n - 1]);
+  EXPECT_EQ(n - 1, b[n - 2]);
+}
+
+// elements with code in their constructors are never built on several threads
+TEST(correctness, parallel_bulk_sequential_types) {
+  bulk_threads_guard guard(4);
+  size_t const n = parallel_bulk_bytes / sizeof(element<size_t>) + 7;
+  {
+    vector<element<size_t> > a(n, element<size_t>(5));
+    vector<element<size_t> > b = a;
+    EXPECT_EQ(5, b[n - 1]);
+    b.resize(2 * n);
+    EXPECT_EQ(2 * n, b.size());
+  }
+  element<size_t>::expect_no_instances();
+}
+
+TEST(correctness, parallel_slices_throw) {
+  bulk_threads_guard guard(4);
+  size_t const n = parallel_bulk_bytes;
+  std::atomic<size_t> done(0), undone(0);
+  EXPECT_THROW(parallel_slices(n, 1, [&](size_t first, size_t last) {
+    if (first == 0)
+      throw std::runtime_error("slice failed");
+    done += last - first;
+  }, [&](size_t first, size_t last) {
+    undone += last - first;
+  }), std::runtime_error);
+  EXPECT_EQ(n - n / 4, done.load());
+  EXPECT_EQ(done.load(), undone.load());
+}
+
+TEST(correctness, concurrent_vector) {
+  size_t const threads = 4;
+  size_t const per_thread = 20000;
+  concurrent_vector<std::string, std::allocator<std::string>, 16> a;
+  std::atomic<bool> torn(false);
+
+  std::thread reader([&] {
+    while (a.size() != threads * per_thread) {
+      size_t size = a.size();
+      if (size != 0 && a[size - 1].empty()) torn = true;
+    }
+  });
+  std::vector<std::thread> writers;
+  for (size_t t = 0; t != threads; ++t) {
+    writers.emplace_back([&a, t] {
+      for (size_t i = 0; i != per_thread; ++i) a.push_back(std::to_string(t * per_thread + i));
+    });
+  }
+  for (auto& w : writers) w.join();
+  reader.join();
+
+  EXPECT_FALSE(torn);
+  ASSERT_EQ(threads * per_thread, a.size());
+  std::vector<bool> seen(threads * per_thread);
+  for (size_t i = 0; i != a.size(); ++i) {
+    size_t value = std::stoul(a[i]);
+    EXPECT_FALSE(seen[value]);
+    seen[value] = true;
+  }
+  EXPECT_LE(a.size(), a.capacity());
+
+  std::string const* first = &a[0];
+  a.reserve(4 * a.size());
+  EXPECT_EQ(first, &a[0]);
+  a.clear();
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ("x", a.emplace_back(1, 'x'));
+}
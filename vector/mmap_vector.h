@@ -0,0 +1,420 @@
+#ifndef MMAP_VECTOR_H
+#define MMAP_VECTOR_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// vector<T> kept in a shared mapping of a file, so the data persists and may exceed RAM;
+// the file is a 64-byte header followed by the elements, and opening it only maps it back
+template <typename T>
+struct mmap_vector {
+    static_assert(std::is_trivially_copyable<T>::value, "mmap_vector stores elements as raw bytes");
+    static_assert(alignof(T) <= 64, "elements are laid out right after a 64-byte header");
+
+    using iterator = T*;
+    using const_iterator = T const* ;
+
+    enum class access { normal, sequential, random, will_need, dont_need };
+
+    explicit mmap_vector(std::string const& path);  // O(1) strong, opens or creates path
+    mmap_vector(mmap_vector&& other) noexcept;       // O(1) nothrow, other is left empty and unmapped
+    mmap_vector& operator=(mmap_vector&& other) noexcept; // O(1) nothrow
+    mmap_vector(mmap_vector const&) = delete;
+    mmap_vector& operator=(mmap_vector const&) = delete;
+
+    ~mmap_vector();                                  // O(1) nothrow, does not flush
+
+    T& operator[](size_t i);                         // O(1) nothrow
+    T const& operator[](size_t i) const;             // O(1) nothrow
+
+    T* data();                                       // O(1) nothrow
+    T const* data() const;                           // O(1) nothrow
+    size_t size() const;                             // O(1) nothrow
+
+    T& front();                                      // O(1) nothrow
+    T const& front() const;                          // O(1) nothrow
+
+    T& back();                                       // O(1) nothrow
+    T const& back() const;                           // O(1) nothrow
+    void push_back(T const&);                        // O(1) amortized, strong
+    void pop_back();                                 // O(1) nothrow
+
+    bool empty() const;                              // O(1) nothrow
+
+    size_t capacity() const;                         // O(1) nothrow
+    void reserve(size_t);                            // O(1) strong, O(N) if the mapping moves
+    void shrink_to_fit();                            // O(1) strong
+    void resize(size_t);                             // O(N) strong, new elements are zero
+    void resize(size_t, T const&);                   // O(N) strong
+
+    void clear();                                    // O(1) nothrow
+
+    void flush();                                    // writes dirty pages back, throws on failure
+    void advise(access);                             // O(1) nothrow, only a hint
+
+    void swap(mmap_vector&);                         // O(1) nothrow
+
+    iterator begin();                                // O(1) nothrow
+    iterator end();                                  // O(1) nothrow
+
+    const_iterator begin() const;                    // O(1) nothrow
+    const_iterator end() const;                      // O(1) nothrow
+
+    iterator insert(const_iterator pos, T const&);   // O(N) strong
+
+    iterator erase(const_iterator pos);              // O(N) nothrow
+
+    iterator erase(const_iterator first, const_iterator last); // O(N) nothrow
+
+private:
+    struct header {
+        uint64_t magic;
+        uint64_t element_size;
+        uint64_t size;
+        char padding[40];
+    };
+
+    static uint64_t const magic = 0x726f746365766d6dULL; // "mmvector"
+
+    static size_t bytes(size_t capacity);
+    static void fail(char const* what);
+
+    header* head() const;
+    void remap(size_t new_capacity);
+    size_t increase_capacity() const;
+
+private:
+    int fd_;
+    char* map_;
+    size_t capacity_;
+};
+
+template <typename T>
+mmap_vector<T>::mmap_vector(std::string const& path)
+    : fd_(::open(path.c_str(), O_RDWR | O_CREAT, 0644))
+    , map_(nullptr)
+    , capacity_(0) {
+    if (fd_ < 0) {
+        fail("open");
+    }
+
+    try {
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) {
+            fail("fstat");
+        }
+        size_t length = static_cast<size_t>(st.st_size);
+        if (length == 0) {
+            length = sizeof(header);
+            if (::ftruncate(fd_, length) != 0) {
+                fail("ftruncate");
+            }
+        } else if (length < sizeof(header)) {
+            throw std::runtime_error("mmap_vector: " + path + " is not a vector file");
+        }
+
+        void* map = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (map == MAP_FAILED) {
+            fail("mmap");
+        }
+        map_ = static_cast<char*>(map);
+        capacity_ = (length - sizeof(header)) / sizeof(T);
+
+        if (head()->magic == 0 && head()->size == 0) {
+            head()->magic = magic;
+            head()->element_size = sizeof(T);
+        }
+        if (head()->magic != magic || head()->element_size != sizeof(T) || head()->size > capacity_) {
+            throw std::runtime_error("mmap_vector: " + path + " holds elements of another type");
+        }
+    } catch (...) {
+        if (map_ != nullptr) {
+            ::munmap(map_, bytes(capacity_));
+        }
+        ::close(fd_);
+        throw;
+    }
+}
+
+template <typename T>
+mmap_vector<T>::mmap_vector(mmap_vector&& other) noexcept
+    : fd_(other.fd_)
+    , map_(other.map_)
+    , capacity_(other.capacity_) {
+    other.fd_ = -1;
+    other.map_ = nullptr;
+    other.capacity_ = 0;
+}
+
+template <typename T>
+mmap_vector<T>& mmap_vector<T>::operator=(mmap_vector&& other) noexcept {
+    mmap_vector tmp(std::move(other));
+    swap(tmp);
+    return *this;
+}
+
+template <typename T>
+mmap_vector<T>::~mmap_vector() {
+    if (map_ != nullptr) {
+        ::munmap(map_, bytes(capacity_));
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+template <typename T>
+T& mmap_vector<T>::operator[](size_t i) {
+    return data()[i];
+}
+
+template <typename T>
+T const& mmap_vector<T>::operator[](size_t i) const {
+    return data()[i];
+}
+
+template <typename T>
+T* mmap_vector<T>::data() {
+    return reinterpret_cast<T*>(map_ + sizeof(header));
+}
+
+template <typename T>
+T const* mmap_vector<T>::data() const {
+    return reinterpret_cast<T const*>(map_ + sizeof(header));
+}
+
+template <typename T>
+size_t mmap_vector<T>::size() const {
+    return map_ == nullptr ? 0 : head()->size;
+}
+
+template <typename T>
+T& mmap_vector<T>::front() {
+    return data()[0];
+}
+
+template <typename T>
+T const& mmap_vector<T>::front() const {
+    return data()[0];
+}
+
+template <typename T>
+T& mmap_vector<T>::back() {
+    return data()[size() - 1];
+}
+
+template <typename T>
+T const& mmap_vector<T>::back() const {
+    return data()[size() - 1];
+}
+
+// value may live in the mapping, which moves when it grows
+template <typename T>
+void mmap_vector<T>::push_back(T const& value) {
+    if (size() == capacity_) {
+        T tmp(value);
+        remap(increase_capacity());
+        data()[head()->size++] = tmp;
+    } else {
+        data()[head()->size++] = value;
+    }
+}
+
+template <typename T>
+void mmap_vector<T>::pop_back() {
+    --head()->size;
+}
+
+template <typename T>
+bool mmap_vector<T>::empty() const {
+    return size() == 0;
+}
+
+template <typename T>
+size_t mmap_vector<T>::capacity() const {
+    return capacity_;
+}
+
+template <typename T>
+void mmap_vector<T>::reserve(size_t new_capacity) {
+    if (capacity_ < new_capacity) {
+        remap(new_capacity);
+    }
+}
+
+template <typename T>
+void mmap_vector<T>::shrink_to_fit() {
+    if (size() < capacity_) {
+        remap(size());
+    }
+}
+
+// ftruncate zero-fills the file, so only slots below the old capacity need clearing; the
+// new region is never touched and stays unallocated until written
+template <typename T>
+void mmap_vector<T>::resize(size_t new_size) {
+    size_t old_size = size();
+    size_t reused = std::min(new_size, capacity_);
+    reserve(new_size);
+    if (reused > old_size) {
+        std::memset(static_cast<void*>(data() + old_size), 0, (reused - old_size) * sizeof(T));
+    }
+    head()->size = new_size;
+}
+
+template <typename T>
+void mmap_vector<T>::resize(size_t new_size, T const& value) {
+    size_t old_size = size();
+    T tmp(value);
+    reserve(new_size);
+    if (new_size > old_size) {
+        std::fill(data() + old_size, data() + new_size, tmp);
+    }
+    head()->size = new_size;
+}
+
+template <typename T>
+void mmap_vector<T>::clear() {
+    if (map_ != nullptr) {
+        head()->size = 0;
+    }
+}
+
+template <typename T>
+void mmap_vector<T>::flush() {
+    if (::msync(map_, bytes(capacity_), MS_SYNC) != 0) {
+        fail("msync");
+    }
+}
+
+template <typename T>
+void mmap_vector<T>::advise(access hint) {
+    int advice = MADV_NORMAL;
+    switch (hint) {
+    case access::normal:
+        advice = MADV_NORMAL;
+        break;
+    case access::sequential:
+        advice = MADV_SEQUENTIAL;
+        break;
+    case access::random:
+        advice = MADV_RANDOM;
+        break;
+    case access::will_need:
+        advice = MADV_WILLNEED;
+        break;
+    case access::dont_need:
+        advice = MADV_DONTNEED;
+        break;
+    }
+    ::madvise(map_, bytes(capacity_), advice);
+}
+
+template <typename T>
+void mmap_vector<T>::swap(mmap_vector& other) {
+    std::swap(fd_, other.fd_);
+    std::swap(map_, other.map_);
+    std::swap(capacity_, other.capacity_);
+}
+
+template <typename T>
+typename mmap_vector<T>::iterator mmap_vector<T>::begin() {
+    return data();
+}
+
+template <typename T>
+typename mmap_vector<T>::iterator mmap_vector<T>::end() {
+    return data() + size();
+}
+
+template <typename T>
+typename mmap_vector<T>::const_iterator mmap_vector<T>::begin() const {
+    return data();
+}
+
+template <typename T>
+typename mmap_vector<T>::const_iterator mmap_vector<T>::end() const {
+    return data() + size();
+}
+
+template <typename T>
+typename mmap_vector<T>::iterator mmap_vector<T>::insert(const_iterator pos, T const& value) {
+    size_t ind = pos - begin();
+    push_back(value);
+    std::rotate(begin() + ind, end() - 1, end());
+    return begin() + ind;
+}
+
+template <typename T>
+typename mmap_vector<T>::iterator mmap_vector<T>::erase(const_iterator pos) {
+    return erase(pos, pos + 1);
+}
+
+template <typename T>
+typename mmap_vector<T>::iterator mmap_vector<T>::erase(const_iterator first, const_iterator last) {
+    size_t ind = first - begin();
+    size_t count = last - first;
+    std::memmove(static_cast<void*>(begin() + ind), static_cast<void const*>(begin() + ind + count),
+                 (size() - ind - count) * sizeof(T));
+    head()->size -= count;
+    return begin() + ind;
+}
+
+template <typename T>
+size_t mmap_vector<T>::bytes(size_t capacity) {
+    return sizeof(header) + capacity * sizeof(T);
+}
+
+template <typename T>
+void mmap_vector<T>::fail(char const* what) {
+    throw std::runtime_error(std::string("mmap_vector: ") + what + ": " + std::strerror(errno));
+}
+
+template <typename T>
+typename mmap_vector<T>::header* mmap_vector<T>::head() const {
+    return reinterpret_cast<header*>(map_);
+}
+
+// the mapping never covers pages past the end of the file: growing resizes the file first
+// and restores it if the mapping cannot follow, shrinking moves the mapping first. A file
+// that then fails to shrink only keeps spare capacity
+template <typename T>
+void mmap_vector<T>::remap(size_t new_capacity) {
+    bool grow = new_capacity > capacity_;
+    if (grow && ::ftruncate(fd_, bytes(new_capacity)) != 0) {
+        fail("ftruncate");
+    }
+    void* map = ::mremap(map_, bytes(capacity_), bytes(new_capacity), MREMAP_MAYMOVE);
+    if (map == MAP_FAILED) {
+        int error = errno;
+        if (grow) {
+            ::ftruncate(fd_, bytes(capacity_));
+        }
+        errno = error;
+        fail("mremap");
+    }
+    map_ = static_cast<char*>(map);
+    capacity_ = new_capacity;
+    if (!grow) {
+        ::ftruncate(fd_, bytes(new_capacity));
+    }
+}
+
+// at least a page at a time, so that small vectors do not remap on every push_back
+template <typename T>
+size_t mmap_vector<T>::increase_capacity() const {
+    return std::max<size_t>(capacity_ * 2, std::max<size_t>(1, 4096 / sizeof(T)));
+}
+
+#endif // MMAP_VECTOR_H
@@ -0,0 +1,504 @@
+#ifndef SEGMENTED_VECTOR_H
+#define SEGMENTED_VECTOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "vector.h"
+
+// smallest power of two number of elements filling at least 64 KiB
+constexpr size_t segment_elements(size_t element_size, size_t count = 1) {
+    return count * element_size >= (1 << 16) ? count : segment_elements(element_size, count * 2);
+}
+
+// vector<T> that grows by appending chunks of ChunkSize elements, so elements never move
+// and pointers and references to them stay valid until they are popped; iterators hold
+// the chunk table and are invalidated when it grows
+template <typename T, typename Allocator = std::allocator<T>, size_t ChunkSize = segment_elements(sizeof(T))>
+struct segmented_vector {
+    static_assert(ChunkSize != 0 && (ChunkSize & (ChunkSize - 1)) == 0, "chunk size must be a power of two");
+
+private:
+    template <bool Const>
+    struct iterator_base;
+
+public:
+    using iterator = iterator_base<false>;
+    using const_iterator = iterator_base<true>;
+    using allocator_type = Allocator;
+
+    segmented_vector();                                     // O(1) nothrow
+    explicit segmented_vector(Allocator const&);            // O(1) nothrow
+    segmented_vector(segmented_vector const& other);        // O(N) strong
+    segmented_vector(segmented_vector&& other) noexcept;    // O(1) nothrow
+    segmented_vector& operator=(segmented_vector const& other); // O(N) strong
+    segmented_vector& operator=(segmented_vector&& other);  // O(1) nothrow with equal allocators, O(N) basic otherwise
+
+    ~segmented_vector();                                    // O(N) nothrow
+
+    allocator_type get_allocator() const;                   // O(1) nothrow
+
+    T& operator[](size_t i);                                // O(1) nothrow
+    T const& operator[](size_t i) const;                    // O(1) nothrow
+
+    size_t size() const;                                    // O(1) nothrow
+
+    T& front();                                             // O(1) nothrow
+    T const& front() const;                                 // O(1) nothrow
+
+    T& back();                                              // O(1) nothrow
+    T const& back() const;                                  // O(1) nothrow
+    void push_back(T const&);                               // O(1) amortized, strong
+    void push_back(T&&);                                    // O(1) amortized, strong
+    template <typename... Args>
+    T& emplace_back(Args&&... args);                        // O(1) amortized, strong
+    void pop_back();                                        // O(1) nothrow
+
+    bool empty() const;                                     // O(1) nothrow
+
+    size_t capacity() const;                                // O(1) nothrow
+    void reserve(size_t);                                   // O(N / ChunkSize) strong
+    void shrink_to_fit();                                   // O(N / ChunkSize) nothrow, frees unused chunks
+    void resize(size_t);                                    // O(N) strong
+    void resize(size_t, T const&);                          // O(N) strong
+
+    void clear();                                           // O(N) nothrow, keeps the chunks
+
+    void swap(segmented_vector&);                           // O(1) nothrow
+
+    iterator begin();                                       // O(1) nothrow
+    iterator end();                                         // O(1) nothrow
+
+    const_iterator begin() const;                           // O(1) nothrow
+    const_iterator end() const;                             // O(1) nothrow
+
+    const_iterator cbegin() const;                          // O(1) nothrow
+    const_iterator cend() const;                            // O(1) nothrow
+
+private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using chunk_allocator = typename alloc_traits::template rebind_alloc<T*>;
+
+    static size_t chunk_of(size_t i);
+    static size_t offset_of(size_t i);
+
+    T* slot(size_t i) const;
+    void add_chunk();
+    void release();
+    void swap_all(segmented_vector&);
+    template <typename... Args>
+    void append(size_t new_size, Args const&... args);
+
+private:
+    Allocator alloc_;
+    vector<T*, chunk_allocator> chunks_;
+    size_t size_;
+};
+
+template <typename T, typename Allocator, size_t ChunkSize>
+template <bool Const>
+struct segmented_vector<T, Allocator, ChunkSize>::iterator_base {
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = typename std::conditional<Const, T const*, T*>::type;
+    using reference = typename std::conditional<Const, T const&, T&>::type;
+    using iterator_category = std::random_access_iterator_tag;
+
+    iterator_base() : chunks_(nullptr), index_(0) {}
+    iterator_base(T* const* chunks, size_t index) : chunks_(chunks), index_(index) {}
+
+    operator iterator_base<true>() const {
+        return iterator_base<true>(chunks_, index_);
+    }
+
+    reference operator*() const {
+        return chunks_[chunk_of(index_)][offset_of(index_)];
+    }
+
+    pointer operator->() const {
+        return &**this;
+    }
+
+    reference operator[](difference_type n) const {
+        return *(*this + n);
+    }
+
+    iterator_base& operator++() {
+        ++index_;
+        return *this;
+    }
+
+    iterator_base operator++(int) {
+        iterator_base old = *this;
+        ++index_;
+        return old;
+    }
+
+    iterator_base& operator--() {
+        --index_;
+        return *this;
+    }
+
+    iterator_base operator--(int) {
+        iterator_base old = *this;
+        --index_;
+        return old;
+    }
+
+    iterator_base& operator+=(difference_type n) {
+        index_ += n;
+        return *this;
+    }
+
+    iterator_base& operator-=(difference_type n) {
+        index_ -= n;
+        return *this;
+    }
+
+    friend iterator_base operator+(iterator_base it, difference_type n) {
+        return it += n;
+    }
+
+    friend iterator_base operator+(difference_type n, iterator_base it) {
+        return it += n;
+    }
+
+    friend iterator_base operator-(iterator_base it, difference_type n) {
+        return it -= n;
+    }
+
+    friend difference_type operator-(iterator_base const& a, iterator_base const& b) {
+        return static_cast<difference_type>(a.index_ - b.index_);
+    }
+
+    friend bool operator==(iterator_base const& a, iterator_base const& b) {
+        return a.index_ == b.index_;
+    }
+
+    friend bool operator!=(iterator_base const& a, iterator_base const& b) {
+        return a.index_ != b.index_;
+    }
+
+    friend bool operator<(iterator_base const& a, iterator_base const& b) {
+        return a.index_ < b.index_;
+    }
+
+    friend bool operator>(iterator_base const& a, iterator_base const& b) {
+        return a.index_ > b.index_;
+    }
+
+    friend bool operator<=(iterator_base const& a, iterator_base const& b) {
+        return a.index_ <= b.index_;
+    }
+
+    friend bool operator>=(iterator_base const& a, iterator_base const& b) {
+        return a.index_ >= b.index_;
+    }
+
+private:
+    T* const* chunks_;
+    size_t index_;
+};
+
+template <typename T, typename Allocator, size_t ChunkSize>
+segmented_vector<T, Allocator, ChunkSize>::segmented_vector()
+    : alloc_()
+    , chunks_(chunk_allocator(alloc_))
+    , size_(0) {}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+segmented_vector<T, Allocator, ChunkSize>::segmented_vector(Allocator const& alloc)
+    : alloc_(alloc)
+    , chunks_(chunk_allocator(alloc_))
+    , size_(0) {}
+
+// the delegated constructor has finished, so a throwing copy is cleaned up by the destructor
+template <typename T, typename Allocator, size_t ChunkSize>
+segmented_vector<T, Allocator, ChunkSize>::segmented_vector(segmented_vector const& other)
+    : segmented_vector(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+    reserve(other.size_);
+    for (size_t i = 0; i != other.size_; i++) {
+        alloc_traits::construct(alloc_, slot(i), other[i]);
+        ++size_;
+    }
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+segmented_vector<T, Allocator, ChunkSize>::segmented_vector(segmented_vector&& other) noexcept
+    : alloc_(std::move(other.alloc_))
+    , chunks_(std::move(other.chunks_))
+    , size_(other.size_) {
+    other.size_ = 0;
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+segmented_vector<T, Allocator, ChunkSize>&
+segmented_vector<T, Allocator, ChunkSize>::operator=(segmented_vector const& other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    segmented_vector tmp(alloc_traits::propagate_on_container_copy_assignment::value ? other.alloc_ : alloc_);
+    tmp.reserve(other.size_);
+    for (size_t i = 0; i != other.size_; i++) {
+        tmp.push_back(other[i]);
+    }
+    swap_all(tmp);
+    return *this;
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+segmented_vector<T, Allocator, ChunkSize>&
+segmented_vector<T, Allocator, ChunkSize>::operator=(segmented_vector&& other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    if (alloc_traits::propagate_on_container_move_assignment::value || alloc_ == other.alloc_) {
+        segmented_vector tmp(std::move(other));
+        swap_all(tmp);
+    } else {
+        clear();
+        reserve(other.size_);
+        for (size_t i = 0; i != other.size_; i++) {
+            push_back(std::move(other[i]));
+        }
+        other.clear();
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+segmented_vector<T, Allocator, ChunkSize>::~segmented_vector() {
+    release();
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+typename segmented_vector<T, Allocator, ChunkSize>::allocator_type
+segmented_vector<T, Allocator, ChunkSize>::get_allocator() const {
+    return alloc_;
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+T& segmented_vector<T, Allocator, ChunkSize>::operator[](size_t i) {
+    return *slot(i);
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+T const& segmented_vector<T, Allocator, ChunkSize>::operator[](size_t i) const {
+    return *slot(i);
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+size_t segmented_vector<T, Allocator, ChunkSize>::size() const {
+    return size_;
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+T& segmented_vector<T, Allocator, ChunkSize>::front() {
+    return *slot(0);
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+T const& segmented_vector<T, Allocator, ChunkSize>::front() const {
+    return *slot(0);
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+T& segmented_vector<T, Allocator, ChunkSize>::back() {
+    return *slot(size_ - 1);
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+T const& segmented_vector<T, Allocator, ChunkSize>::back() const {
+    return *slot(size_ - 1);
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+void segmented_vector<T, Allocator, ChunkSize>::push_back(T const& value) {
+    emplace_back(value);
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+void segmented_vector<T, Allocator, ChunkSize>::push_back(T&& value) {
+    emplace_back(std::move(value));
+}
+
+// a new chunk does not move the existing elements, so args may refer to them
+template <typename T, typename Allocator, size_t ChunkSize>
+template <typename... Args>
+T& segmented_vector<T, Allocator, ChunkSize>::emplace_back(Args&&... args) {
+    if (size_ == capacity()) {
+        add_chunk();
+    }
+    T* p = slot(size_);
+    alloc_traits::construct(alloc_, p, std::forward<Args>(args)...);
+    ++size_;
+    return *p;
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+void segmented_vector<T, Allocator, ChunkSize>::pop_back() {
+    alloc_traits::destroy(alloc_, slot(--size_));
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+bool segmented_vector<T, Allocator, ChunkSize>::empty() const {
+    return size_ == 0;
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+size_t segmented_vector<T, Allocator, ChunkSize>::capacity() const {
+    return chunks_.size() * ChunkSize;
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+void segmented_vector<T, Allocator, ChunkSize>::reserve(size_t new_capacity) {
+    if (capacity() >= new_capacity) {
+        return;
+    }
+    chunks_.reserve(chunk_of(new_capacity - 1) + 1);
+    while (capacity() < new_capacity) {
+        add_chunk();
+    }
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+void segmented_vector<T, Allocator, ChunkSize>::shrink_to_fit() {
+    size_t used = size_ == 0 ? 0 : chunk_of(size_ - 1) + 1;
+    while (chunks_.size() != used) {
+        alloc_traits::deallocate(alloc_, chunks_.back(), ChunkSize);
+        chunks_.pop_back();
+    }
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+void segmented_vector<T, Allocator, ChunkSize>::resize(size_t new_size) {
+    append(new_size);
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+void segmented_vector<T, Allocator, ChunkSize>::resize(size_t new_size, T const& value) {
+    if (new_size <= size_) {
+        append(new_size);
+    } else {
+        T tmp(value);
+        append(new_size, tmp);
+    }
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+void segmented_vector<T, Allocator, ChunkSize>::clear() {
+    while (size_ != 0) {
+        pop_back();
+    }
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+void segmented_vector<T, Allocator, ChunkSize>::swap(segmented_vector& other) {
+    if (alloc_traits::propagate_on_container_swap::value) {
+        std::swap(alloc_, other.alloc_);
+    }
+    chunks_.swap(other.chunks_);
+    std::swap(size_, other.size_);
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+typename segmented_vector<T, Allocator, ChunkSize>::iterator segmented_vector<T, Allocator, ChunkSize>::begin() {
+    return iterator(chunks_.data(), 0);
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+typename segmented_vector<T, Allocator, ChunkSize>::iterator segmented_vector<T, Allocator, ChunkSize>::end() {
+    return iterator(chunks_.data(), size_);
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+typename segmented_vector<T, Allocator, ChunkSize>::const_iterator
+segmented_vector<T, Allocator, ChunkSize>::begin() const {
+    return const_iterator(chunks_.data(), 0);
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+typename segmented_vector<T, Allocator, ChunkSize>::const_iterator
+segmented_vector<T, Allocator, ChunkSize>::end() const {
+    return const_iterator(chunks_.data(), size_);
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+typename segmented_vector<T, Allocator, ChunkSize>::const_iterator
+segmented_vector<T, Allocator, ChunkSize>::cbegin() const {
+    return begin();
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+typename segmented_vector<T, Allocator, ChunkSize>::const_iterator
+segmented_vector<T, Allocator, ChunkSize>::cend() const {
+    return end();
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+size_t segmented_vector<T, Allocator, ChunkSize>::chunk_of(size_t i) {
+    return i / ChunkSize;
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+size_t segmented_vector<T, Allocator, ChunkSize>::offset_of(size_t i) {
+    return i % ChunkSize;
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+T* segmented_vector<T, Allocator, ChunkSize>::slot(size_t i) const {
+    return chunks_[chunk_of(i)] + offset_of(i);
+}
+
+// the chunk table only ever copies pointers
+template <typename T, typename Allocator, size_t ChunkSize>
+void segmented_vector<T, Allocator, ChunkSize>::add_chunk() {
+    T* chunk = alloc_traits::allocate(alloc_, ChunkSize);
+    try {
+        chunks_.push_back(chunk);
+    } catch (...) {
+        alloc_traits::deallocate(alloc_, chunk, ChunkSize);
+        throw;
+    }
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+void segmented_vector<T, Allocator, ChunkSize>::release() {
+    clear();
+    shrink_to_fit();
+}
+
+template <typename T, typename Allocator, size_t ChunkSize>
+void segmented_vector<T, Allocator, ChunkSize>::swap_all(segmented_vector& other) {
+    std::swap(alloc_, other.alloc_);
+    chunks_.swap(other.chunks_);
+    std::swap(size_, other.size_);
+}
+
+// shrinks, or constructs the missing elements from args and drops them all if one throws
+template <typename T, typename Allocator, size_t ChunkSize>
+template <typename... Args>
+void segmented_vector<T, Allocator, ChunkSize>::append(size_t new_size, Args const&... args) {
+    while (size_ > new_size) {
+        pop_back();
+    }
+    size_t old_size = size_;
+    reserve(new_size);
+    try {
+        while (size_ != new_size) {
+            alloc_traits::construct(alloc_, slot(size_), args...);
+            ++size_;
+        }
+    } catch (...) {
+        while (size_ != old_size) {
+            pop_back();
+        }
+        throw;
+    }
+}
+
+#endif // SEGMENTED_VECTOR_H
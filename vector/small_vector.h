@@ -0,0 +1,631 @@
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+// vector<T> that keeps up to N elements inside the object and spills to the heap beyond that;
+// moving or swapping an inline small_vector moves its elements one by one
+template <typename T, size_t N, typename Allocator = std::allocator<T>>
+struct small_vector {
+    static_assert(N > 0, "small_vector needs room for at least one inline element");
+
+    using iterator = T*;
+    using const_iterator = T const* ;
+    using allocator_type = Allocator;
+
+    small_vector();                                     // O(1) nothrow
+    explicit small_vector(Allocator const&);            // O(1) nothrow
+    small_vector(small_vector const& other);            // O(N) strong
+    small_vector(small_vector&& other) noexcept(nothrow_relocate::value); // O(1) on the heap, O(N) inline
+    small_vector& operator=(small_vector const& other); // O(N) strong
+    small_vector& operator=(small_vector&& other);      // O(1) nothrow on the heap, O(N) weak inline
+
+    ~small_vector();                                    // O(N) nothrow
+
+    allocator_type get_allocator() const;               // O(1) nothrow
+
+    T& operator[](size_t i);                            // O(1) nothrow
+    T const& operator[](size_t i) const;                // O(1) nothrow
+
+    T* data();                                          // O(1) nothrow
+    T const* data() const;                              // O(1) nothrow
+    size_t size() const;                                // O(1) nothrow
+
+    T& front();                                         // O(1) nothrow
+    T const& front() const;                             // O(1) nothrow
+
+    T& back();                                          // O(1) nothrow
+    T const& back() const;                              // O(1) nothrow
+    void push_back(T const&);                           // O(1) amortized, strong
+    void push_back(T&&);                                // O(1) amortized, strong
+    template <typename... Args>
+    T& emplace_back(Args&&... args);                    // O(1) amortized, strong
+    void pop_back();                                    // O(1) nothrow
+
+    bool empty() const;                                 // O(1) nothrow
+    bool is_inline() const;                             // O(1) nothrow
+
+    size_t capacity() const;                            // O(1) nothrow
+    void reserve(size_t);                               // O(N) strong
+    void shrink_to_fit();                               // O(N) strong, moves back inline when size() <= N
+    void resize(size_t);                                // O(N) strong
+    void resize(size_t, T const&);                      // O(N) strong
+
+    void clear();                                       // O(N) nothrow
+
+    void swap(small_vector&);                           // O(1) nothrow on the heap, O(N) weak inline
+
+    iterator begin();                                   // O(1) nothrow
+    iterator end();                                     // O(1) nothrow
+
+    const_iterator begin() const;                       // O(1) nothrow
+    const_iterator end() const;                         // O(1) nothrow
+
+    const_iterator cbegin() const;                      // O(1) nothrow
+    const_iterator cend() const;                        // O(1) nothrow
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args); // O(N) weak
+    iterator insert(const_iterator pos, T const&);      // O(N) weak
+    iterator insert(const_iterator pos, size_t count, T const&); // O(N + count) weak
+    template <typename InputIt, typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    iterator insert(const_iterator pos, InputIt first, InputIt last); // O(N + M) weak
+
+    iterator erase(const_iterator pos);                 // O(N) weak
+
+    iterator erase(const_iterator first, const_iterator last); // O(N) weak
+
+private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using nothrow_relocate = std::integral_constant<bool, std::is_trivially_copyable<T>::value
+                                                          || std::is_nothrow_move_constructible<T>::value>;
+
+    T* inline_data();
+    size_t increase_capacity() const;
+    void new_buffer(size_t new_capacity);
+    void adopt(small_vector& other);
+    void release();
+    void append_from(small_vector const& other);
+    template <typename... Args>
+    void emplace_back_realloc(Args&&... args);
+    template <typename InputIt>
+    void reserve_for(InputIt first, InputIt last, std::input_iterator_tag);
+    template <typename ForwardIt>
+    void reserve_for(ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+
+    void destroy_all(T* vec, size_t size);
+    void relocate_all(T* dst, T* src, size_t size);
+    T* allocate(size_t size);
+    void deallocate(T* ptr, size_t size);
+
+private:
+    Allocator alloc_;
+    T* data_;
+    size_t size_;
+    size_t capacity_;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type inline_[N];
+};
+
+template <typename T, size_t N, typename Allocator>
+small_vector<T, N, Allocator>::small_vector()
+    : alloc_()
+    , data_(inline_data())
+    , size_(0)
+    , capacity_(N) {}
+
+template <typename T, size_t N, typename Allocator>
+small_vector<T, N, Allocator>::small_vector(Allocator const& alloc)
+    : alloc_(alloc)
+    , data_(inline_data())
+    , size_(0)
+    , capacity_(N) {}
+
+template <typename T, size_t N, typename Allocator>
+small_vector<T, N, Allocator>::small_vector(small_vector const& other)
+    : small_vector(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+    append_from(other);
+}
+
+template <typename T, size_t N, typename Allocator>
+small_vector<T, N, Allocator>::small_vector(small_vector&& other) noexcept(nothrow_relocate::value)
+    : small_vector(other.alloc_) {
+    adopt(other);
+}
+
+// copies into a heap buffer unless moving the copy inline cannot throw, so that this
+// stays untouched until the copy is complete
+template <typename T, size_t N, typename Allocator>
+small_vector<T, N, Allocator>& small_vector<T, N, Allocator>::operator=(small_vector const& other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    Allocator alloc = alloc_traits::propagate_on_container_copy_assignment::value ? other.alloc_ : alloc_;
+    small_vector tmp(alloc);
+    if (!nothrow_relocate::value && other.size_ <= N) {
+        tmp.new_buffer(N + 1);
+    }
+    tmp.append_from(other);
+
+    release();
+    alloc_ = tmp.alloc_;
+    adopt(tmp);
+    return *this;
+}
+
+template <typename T, size_t N, typename Allocator>
+small_vector<T, N, Allocator>& small_vector<T, N, Allocator>::operator=(small_vector&& other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    release();
+    if (alloc_traits::propagate_on_container_move_assignment::value) {
+        alloc_ = std::move(other.alloc_);
+    }
+    adopt(other);
+    return *this;
+}
+
+template <typename T, size_t N, typename Allocator>
+small_vector<T, N, Allocator>::~small_vector() {
+    release();
+}
+
+template <typename T, size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::allocator_type small_vector<T, N, Allocator>::get_allocator() const {
+    return alloc_;
+}
+
+template <typename T, size_t N, typename Allocator>
+T& small_vector<T, N, Allocator>::operator[](size_t i) {
+    return data_[i];
+}
+
+template <typename T, size_t N, typename Allocator>
+T const& small_vector<T, N, Allocator>::operator[](size_t i) const {
+    return data_[i];
+}
+
+template <typename T, size_t N, typename Allocator>
+T* small_vector<T, N, Allocator>::data() {
+    return data_;
+}
+
+template <typename T, size_t N, typename Allocator>
+T const* small_vector<T, N, Allocator>::data() const {
+    return data_;
+}
+
+template <typename T, size_t N, typename Allocator>
+size_t small_vector<T, N, Allocator>::size() const {
+    return size_;
+}
+
+template <typename T, size_t N, typename Allocator>
+T& small_vector<T, N, Allocator>::front() {
+    return *data_;
+}
+
+template <typename T, size_t N, typename Allocator>
+T const& small_vector<T, N, Allocator>::front() const {
+    return *data_;
+}
+
+template <typename T, size_t N, typename Allocator>
+T& small_vector<T, N, Allocator>::back() {
+    return data_[size_ - 1];
+}
+
+template <typename T, size_t N, typename Allocator>
+T const& small_vector<T, N, Allocator>::back() const {
+    return data_[size_ - 1];
+}
+
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::push_back(T const& value) {
+    emplace_back(value);
+}
+
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::push_back(T&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T, size_t N, typename Allocator>
+template <typename... Args>
+T& small_vector<T, N, Allocator>::emplace_back(Args&&... args) {
+    if (size_ != capacity_) {
+        alloc_traits::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
+        ++size_;
+    } else {
+        emplace_back_realloc(std::forward<Args>(args)...);
+    }
+    return data_[size_ - 1];
+}
+
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::pop_back() {
+    alloc_traits::destroy(alloc_, data_ + --size_);
+}
+
+template <typename T, size_t N, typename Allocator>
+bool small_vector<T, N, Allocator>::empty() const {
+    return size_ == 0;
+}
+
+template <typename T, size_t N, typename Allocator>
+bool small_vector<T, N, Allocator>::is_inline() const {
+    return data_ == reinterpret_cast<T const*>(inline_);
+}
+
+template <typename T, size_t N, typename Allocator>
+size_t small_vector<T, N, Allocator>::capacity() const {
+    return capacity_;
+}
+
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::reserve(size_t new_capacity) {
+    if (capacity_ < new_capacity) {
+        new_buffer(new_capacity);
+    }
+}
+
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::shrink_to_fit() {
+    if (!is_inline() && size_ < capacity_) {
+        new_buffer(size_);
+    }
+}
+
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::resize(size_t new_size) {
+    if (new_size <= size_) {
+        destroy_all(data_ + new_size, size_ - new_size);
+        size_ = new_size;
+        return;
+    }
+    if (new_size > capacity_) {
+        new_buffer(std::max(increase_capacity(), new_size));
+    }
+
+    size_t i = size_;
+    try {
+        for (; i < new_size; i++) {
+            alloc_traits::construct(alloc_, data_ + i);
+        }
+    } catch (...) {
+        destroy_all(data_ + size_, i - size_);
+        throw;
+    }
+    size_ = new_size;
+}
+
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::resize(size_t new_size, T const& value) {
+    if (new_size <= size_) {
+        destroy_all(data_ + new_size, size_ - new_size);
+        size_ = new_size;
+        return;
+    }
+    T tmp(value);
+    if (new_size > capacity_) {
+        new_buffer(std::max(increase_capacity(), new_size));
+    }
+
+    size_t i = size_;
+    try {
+        for (; i < new_size; i++) {
+            alloc_traits::construct(alloc_, data_ + i, tmp);
+        }
+    } catch (...) {
+        destroy_all(data_ + size_, i - size_);
+        throw;
+    }
+    size_ = new_size;
+}
+
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::clear() {
+    destroy_all(data_, size_);
+    size_ = 0;
+}
+
+// two heap buffers trade places, anything inline goes through a third small_vector
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::swap(small_vector& other) {
+    if (this == &other) {
+        return;
+    }
+    if (!is_inline() && !other.is_inline()) {
+        if (alloc_traits::propagate_on_container_swap::value) {
+            std::swap(alloc_, other.alloc_);
+        }
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        return;
+    }
+
+    small_vector tmp(alloc_);
+    tmp.adopt(*this);
+    if (alloc_traits::propagate_on_container_swap::value) {
+        alloc_ = other.alloc_;
+    }
+    adopt(other);
+    if (alloc_traits::propagate_on_container_swap::value) {
+        other.alloc_ = tmp.alloc_;
+    }
+    other.adopt(tmp);
+}
+
+template <typename T, size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::iterator small_vector<T, N, Allocator>::begin() {
+    return data_;
+}
+
+template <typename T, size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::iterator small_vector<T, N, Allocator>::end() {
+    return data_ + size_;
+}
+
+template <typename T, size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::const_iterator small_vector<T, N, Allocator>::begin() const {
+    return data_;
+}
+
+template <typename T, size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::const_iterator small_vector<T, N, Allocator>::end() const {
+    return data_ + size_;
+}
+
+template <typename T, size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::const_iterator small_vector<T, N, Allocator>::cbegin() const {
+    return begin();
+}
+
+template <typename T, size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::const_iterator small_vector<T, N, Allocator>::cend() const {
+    return end();
+}
+
+// new elements are appended, which is strong, and rotated into place
+template <typename T, size_t N, typename Allocator>
+template <typename... Args>
+typename small_vector<T, N, Allocator>::iterator small_vector<T, N, Allocator>::emplace(const_iterator pos,
+                                                                                         Args&&... args) {
+    size_t ind = pos - begin();
+    emplace_back(std::forward<Args>(args)...);
+    std::rotate(begin() + ind, end() - 1, end());
+    return begin() + ind;
+}
+
+template <typename T, size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::iterator small_vector<T, N, Allocator>::insert(const_iterator pos,
+                                                                                        T const& val) {
+    return emplace(pos, val);
+}
+
+template <typename T, size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::iterator small_vector<T, N, Allocator>::insert(const_iterator pos,
+                                                                                        size_t count, T const& val) {
+    size_t ind = pos - begin();
+    size_t old_size = size_;
+    T tmp(val);
+    if (size_ + count > capacity_) {
+        new_buffer(std::max(increase_capacity(), size_ + count));
+    }
+    try {
+        for (size_t i = 0; i < count; i++) {
+            emplace_back(tmp);
+        }
+    } catch (...) {
+        resize(old_size);
+        throw;
+    }
+    std::rotate(begin() + ind, begin() + old_size, end());
+    return begin() + ind;
+}
+
+template <typename T, size_t N, typename Allocator>
+template <typename InputIt, typename>
+typename small_vector<T, N, Allocator>::iterator small_vector<T, N, Allocator>::insert(const_iterator pos,
+                                                                                        InputIt first, InputIt last) {
+    size_t ind = pos - begin();
+    size_t old_size = size_;
+    reserve_for(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    try {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    } catch (...) {
+        resize(old_size);
+        throw;
+    }
+    std::rotate(begin() + ind, begin() + old_size, end());
+    return begin() + ind;
+}
+
+template <typename T, size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::iterator small_vector<T, N, Allocator>::erase(const_iterator pos) {
+    return erase(pos, pos + 1);
+}
+
+template <typename T, size_t N, typename Allocator>
+typename small_vector<T, N, Allocator>::iterator small_vector<T, N, Allocator>::erase(const_iterator first,
+                                                                                       const_iterator last) {
+    size_t ind = first - begin();
+    size_t count = last - first;
+    if (count != 0) {
+        std::move(begin() + ind + count, end(), begin() + ind);
+        destroy_all(data_ + size_ - count, count);
+        size_ -= count;
+    }
+    return begin() + ind;
+}
+
+template <typename T, size_t N, typename Allocator>
+T* small_vector<T, N, Allocator>::inline_data() {
+    return reinterpret_cast<T*>(inline_);
+}
+
+template <typename T, size_t N, typename Allocator>
+size_t small_vector<T, N, Allocator>::increase_capacity() const {
+    return capacity_ * 2;
+}
+
+// capacities up to N go back to the inline storage
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::new_buffer(size_t new_capacity) {
+    if (new_capacity <= N && is_inline()) {
+        return;
+    }
+    T* buffer = new_capacity <= N ? inline_data() : allocate(new_capacity);
+    try {
+        relocate_all(buffer, data_, size_);
+    } catch (...) {
+        if (buffer != inline_data()) {
+            deallocate(buffer, new_capacity);
+        }
+        throw;
+    }
+    destroy_all(data_, size_);
+    if (!is_inline()) {
+        deallocate(data_, capacity_);
+    }
+    data_ = buffer;
+    capacity_ = std::max(new_capacity, N);
+}
+
+// takes the heap buffer or the elements of other, leaving it empty and inline; this must be empty
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::adopt(small_vector& other) {
+    if (!other.is_inline() && alloc_ == other.alloc_) {
+        data_ = other.data_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        other.data_ = other.inline_data();
+        other.size_ = 0;
+        other.capacity_ = N;
+        return;
+    }
+
+    reserve(other.size_);
+    relocate_all(data_, other.data_, other.size_);
+    size_ = other.size_;
+    other.release();
+}
+
+// destroys everything and returns to the empty inline state
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::release() {
+    destroy_all(data_, size_);
+    if (!is_inline()) {
+        deallocate(data_, capacity_);
+    }
+    data_ = inline_data();
+    size_ = 0;
+    capacity_ = N;
+}
+
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::append_from(small_vector const& other) {
+    reserve(size_ + other.size_);
+    size_t i = 0;
+    try {
+        for (; i < other.size_; i++) {
+            alloc_traits::construct(alloc_, data_ + size_ + i, other.data_[i]);
+        }
+    } catch (...) {
+        destroy_all(data_ + size_, i);
+        throw;
+    }
+    size_ += other.size_;
+}
+
+// the new element is built first, its arguments may refer to the elements being relocated
+template <typename T, size_t N, typename Allocator>
+template <typename... Args>
+void small_vector<T, N, Allocator>::emplace_back_realloc(Args&&... args) {
+    size_t new_capacity = increase_capacity();
+    T* buffer = allocate(new_capacity);
+
+    try {
+        alloc_traits::construct(alloc_, buffer + size_, std::forward<Args>(args)...);
+        try {
+            relocate_all(buffer, data_, size_);
+        } catch (...) {
+            alloc_traits::destroy(alloc_, buffer + size_);
+            throw;
+        }
+    } catch (...) {
+        deallocate(buffer, new_capacity);
+        throw;
+    }
+    destroy_all(data_, size_);
+    if (!is_inline()) {
+        deallocate(data_, capacity_);
+    }
+    data_ = buffer;
+    capacity_ = new_capacity;
+    ++size_;
+}
+
+template <typename T, size_t N, typename Allocator>
+template <typename InputIt>
+void small_vector<T, N, Allocator>::reserve_for(InputIt, InputIt, std::input_iterator_tag) {}
+
+template <typename T, size_t N, typename Allocator>
+template <typename ForwardIt>
+void small_vector<T, N, Allocator>::reserve_for(ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+    size_t count = std::distance(first, last);
+    if (size_ + count > capacity_) {
+        new_buffer(std::max(increase_capacity(), size_ + count));
+    }
+}
+
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::destroy_all(T* vec, size_t size) {
+    while (size > 0) {
+        size--;
+        alloc_traits::destroy(alloc_, vec + size);
+    }
+}
+
+// moves when that cannot throw, src stays intact if a copy throws; the caller destroys src
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::relocate_all(T* dst, T* src, size_t size) {
+    if (std::is_trivially_copyable<T>::value) {
+        if (size != 0) {
+            std::memcpy(static_cast<void*>(dst), static_cast<void const*>(src), size * sizeof(T));
+        }
+        return;
+    }
+
+    size_t i = 0;
+    try {
+        for (; i < size; i++) {
+            alloc_traits::construct(alloc_, dst + i, std::move_if_noexcept(src[i]));
+        }
+    } catch (...) {
+        destroy_all(dst, i);
+        throw;
+    }
+}
+
+template <typename T, size_t N, typename Allocator>
+T* small_vector<T, N, Allocator>::allocate(size_t size) {
+    return alloc_traits::allocate(alloc_, size);
+}
+
+template <typename T, size_t N, typename Allocator>
+void small_vector<T, N, Allocator>::deallocate(T* ptr, size_t size) {
+    alloc_traits::deallocate(alloc_, ptr, size);
+}
+
+#endif // SMALL_VECTOR_H
@@ -4,18 +4,150 @@
 #include <cstddef>
 #include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+// growth policies map the current capacity to the next one for elements of a given size;
+// auto_shrink lets the vector halve its buffer once size drops below a quarter of it
+template <size_t Num, size_t Den>
+struct factor_growth {
+    static bool const auto_shrink = false;
+
+    static size_t next_capacity(size_t capacity, size_t) {
+        return std::max(capacity + 1, capacity * Num / Den);
+    }
+};
+
+using doubling_growth = factor_growth<2, 1>;
+
+// whole pages, so that large buffers do not leave a partial page unused
+template <typename Growth = doubling_growth, size_t Page = 4096>
+struct page_growth {
+    static bool const auto_shrink = Growth::auto_shrink;
+
+    static size_t next_capacity(size_t capacity, size_t element_size) {
+        size_t bytes = Growth::next_capacity(capacity, element_size) * element_size;
+        return (bytes + Page - 1) / Page * Page / element_size;
+    }
+};
+
+// doubles until the buffer reaches Limit bytes, then grows by Limit bytes at a time
+template <size_t Limit>
+struct capped_growth {
+    static bool const auto_shrink = false;
+
+    static size_t next_capacity(size_t capacity, size_t element_size) {
+        if (capacity * element_size < Limit) {
+            return std::max<size_t>(1, capacity * 2);
+        }
+        return capacity + std::max<size_t>(1, Limit / element_size);
+    }
+};
+
+// pop_back, erase and resize down may then reallocate, which invalidates every iterator
+// and reference, and that call is O(N); it stays O(1) amortized as the buffer only halves
+// once three quarters of it are unused
+template <typename Growth>
+struct shrinking : Growth {
+    static bool const auto_shrink = true;
+};
 
-template <typename T>
+// bulk copies and fills of trivially copyable elements switch to parallel_bulk_threads()
+// threads from this many bytes on; they only move bytes, so no code of T ever runs on
+// more than one thread
+size_t const parallel_bulk_bytes = size_t(1) << 24;
+
+// threads used by the bulk paths, 0 meaning std::thread::hardware_concurrency()
+inline std::atomic<size_t>& parallel_bulk_threads() {
+    static std::atomic<size_t> threads(0);
+    return threads;
+}
+
+// runs body(first, last) on slices of [0, count), one per parallel_bulk_threads() once the range
+// spans parallel_bulk_bytes. Each slice of a fresh buffer is first touched by the thread
+// filling it, so its pages land on that thread's NUMA node. A throwing body must leave its
+// slice untouched; the slices that did complete are then passed to undo and the first
+// exception is rethrown
+template <typename Body, typename Undo>
+void parallel_slices(size_t count, size_t element_size, Body const& body, Undo const& undo) {
+    size_t threads = parallel_bulk_threads().load(std::memory_order_relaxed);
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (count * element_size < parallel_bulk_bytes) {
+        threads = 1;
+    }
+    if (threads <= 1) {
+        body(0, count);
+        return;
+    }
+
+    size_t step = (count + threads - 1) / threads;
+    std::unique_ptr<std::exception_ptr[]> errors(new std::exception_ptr[threads]);
+    std::unique_ptr<std::thread[]> workers(new std::thread[threads]);
+    auto slice = [&](size_t t) {
+        try {
+            body(std::min(count, t * step), std::min(count, (t + 1) * step));
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+    for (size_t t = 1; t < threads; t++) {
+        try {
+            workers[t] = std::thread(slice, t);
+        } catch (...) {
+            slice(t);
+        }
+    }
+    slice(0);
+
+    std::exception_ptr error;
+    for (size_t t = 0; t < threads; t++) {
+        if (workers[t].joinable()) {
+            workers[t].join();
+        }
+        if (errors[t] && !error) {
+            error = errors[t];
+        }
+    }
+    if (error) {
+        for (size_t t = 0; t < threads; t++) {
+            if (!errors[t]) {
+                undo(std::min(count, t * step), std::min(count, (t + 1) * step));
+            }
+        }
+        std::rethrow_exception(error);
+    }
+}
+
+// Allocator must use plain T* pointers; it is propagated on copy assignment, move
+// assignment and swap as its std::allocator_traits say. Bulk construction may call
+// Allocator::construct from several threads at once
+template <typename T, typename Allocator = std::allocator<T>, typename Growth = doubling_growth>
 struct vector {
     using iterator = T*;
     using const_iterator = T const* ;
+    using allocator_type = Allocator;
 
     vector();                               // O(1) nothrow
+    explicit vector(Allocator const&);      // O(1) nothrow
     vector(vector const& other);            // O(N) strong
+    vector(vector const&, Allocator const&); // O(N) strong
+    vector(size_t count, T const& value, Allocator const& = Allocator()); // O(N) strong
+    template <typename InputIt, typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    vector(InputIt first, InputIt last, Allocator const& = Allocator()); // O(N) strong
+    vector(vector&& other) noexcept;        // O(1) nothrow
     vector& operator=(vector const& other); // O(N) strong
+    vector& operator=(vector&& other);      // O(1) nothrow, O(N) strong for unequal allocators without propagation
 
     ~vector();                              // O(N) nothrow
 
+    allocator_type get_allocator() const;   // O(1) nothrow
+
     T& operator[](size_t i);                // O(1) nothrow
     T const& operator[](size_t i) const;    // O(1) nothrow
 
@@ -29,16 +161,25 @@ struct vector {
     T& back();                              // O(1) nothrow
     T const& back() const;                  // O(1) nothrow
     void push_back(T const&);               // O(1) strong
-    void pop_back();                        // O(1) nothrow
+    void push_back(T&&);                    // O(1) strong
+    template <typename... Args>
+    T& emplace_back(Args&&... args);        // O(1) strong
+    void pop_back();                        // O(1) nothrow, O(N) when shrinking<> reallocates
 
     bool empty() const;                     // O(1) nothrow
 
     size_t capacity() const;                // O(1) nothrow
     void reserve(size_t);                   // O(N) strong
     void shrink_to_fit();                   // O(N) strong
+    void resize(size_t);                    // O(N) strong
+    void resize(size_t, T const&);          // O(N) strong
 
     void clear();                           // O(N) nothrow
 
+    void assign(size_t count, T const& value); // O(N) strong
+    template <typename InputIt, typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    void assign(InputIt first, InputIt last); // O(N) strong
+
     void swap(vector&);                     // O(1) nothrow
 
     iterator begin();                       // O(1) nothrow
@@ -50,41 +191,121 @@ struct vector {
     const_iterator cbegin() const;           // O(1) nothrow
     const_iterator cend() const;             // O(1) nothrow
 
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args); // O(N) weak, strong on reallocation
     iterator insert(const_iterator pos, T const&); // O(N) weak
+    iterator insert(const_iterator pos, size_t count, T const&); // O(N + count) weak, strong on reallocation
+    template <typename InputIt, typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    iterator insert(const_iterator pos, InputIt first, InputIt last); // O(N + M) weak, strong on reallocation
 
     iterator erase(const_iterator pos);     // O(N) weak
 
     iterator erase(const_iterator first, const_iterator last); // O(N) weak
 
 private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+
     size_t increase_capacity() const;
-    void push_back_realloc(T const&);
+    void shrink_if_sparse();
+    template <typename... Args>
+    void emplace_back_realloc(Args&&... args);
     void new_buffer(size_t new_capacity);
+    void swap_all(vector&);
 
-    static void destroy_all(T* vec, size_t size);
-    static void copy_construct_all(T* dst, T const* src, size_t size);
-    static T* allocate(size_t size);
+    // yields the same element forever, feeds count insertion and filling through the range code
+    struct repeat_iterator {
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T const*;
+        using reference = T const&;
+        using iterator_category = std::random_access_iterator_tag;
+
+        T const* value;
+
+        T const& operator*() const {
+            return *value;
+        }
+
+        repeat_iterator& operator++() {
+            return *this;
+        }
+
+        repeat_iterator operator+(size_t) const {
+            return *this;
+        }
+    };
+
+    template <typename InputIt>
+    iterator insert_range(size_t ind, InputIt first, InputIt last, std::input_iterator_tag);
+    template <typename ForwardIt>
+    iterator insert_range(size_t ind, ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+    template <typename ForwardIt>
+    iterator insert_forward(size_t ind, ForwardIt first, size_t count);
+    template <typename ForwardIt>
+    void insert_shift(size_t ind, ForwardIt first, size_t count, std::true_type);
+    template <typename ForwardIt>
+    void insert_shift(size_t ind, ForwardIt first, size_t count, std::false_type);
+    template <typename ForwardIt>
+    void insert_realloc(size_t ind, ForwardIt first, size_t count);
+    void erase_shift(size_t ind, size_t count, std::true_type);
+    void erase_shift(size_t ind, size_t count, std::false_type);
+
+    void destroy_all(T* vec, size_t size);
+    void copy_construct_all(T* dst, T const* src, size_t size);
+    void copy_construct_all(T* dst, T const* src, size_t size, std::true_type);
+    void copy_construct_all(T* dst, T const* src, size_t size, std::false_type);
+    void relocate_all(T* dst, T* src, size_t size);
+    void relocate_all(T* dst, T* src, size_t size, std::true_type);
+    void relocate_all(T* dst, T* src, size_t size, std::false_type);
+    void move_construct_all(T* dst, T* src, size_t size);
+    void move_construct_all(T* dst, T* src, size_t size, std::true_type);
+    void move_construct_all(T* dst, T* src, size_t size, std::false_type);
+    void default_construct_all(T* dst, size_t size);
+    void default_construct_all(T* dst, size_t size, std::true_type);
+    void default_construct_all(T* dst, size_t size, std::false_type);
+    template <typename ForwardIt>
+    void construct_from(T* dst, ForwardIt first, size_t count);
+    template <typename ForwardIt>
+    void construct_from(T* dst, ForwardIt first, size_t count, std::true_type);
+    template <typename ForwardIt>
+    void construct_from(T* dst, ForwardIt first, size_t count, std::false_type);
+    T* allocate(size_t size);
+    void deallocate(T* ptr, size_t size);
 
 private:
+    Allocator alloc_;
     T* data_;
     size_t size_;
     size_t capacity_;
 };
 
-template <typename T>
-vector<T>::vector()
-    : data_(nullptr)
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector()
+    : alloc_()
+    , data_(nullptr)
+    , size_(0)
+    , capacity_(0) {}
+
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(Allocator const& alloc)
+    : alloc_(alloc)
+    , data_(nullptr)
     , size_(0)
     , capacity_(0) {}
 
-template <typename T>
-vector<T>::vector(vector<T> const& other) {
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(vector<T, Allocator, Growth> const& other)
+    : vector(other, alloc_traits::select_on_container_copy_construction(other.alloc_)) {}
+
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(vector<T, Allocator, Growth> const& other, Allocator const& alloc)
+    : alloc_(alloc) {
     T* ptr = allocate(other.size_);
 
     try {
         copy_construct_all(ptr, other.data_, other.size_);
     } catch (...) {
-        operator delete (ptr);
+        deallocate(ptr, other.size_);
         throw;
     }
 
@@ -93,222 +314,523 @@ vector<T>::vector(vector<T> const& other) {
     capacity_ = size_;
 }
 
-template <typename T>
-vector<T>& vector<T>::operator=(vector<T> const& other) {
+// the delegated constructor has finished, so a throwing fill is cleaned up by the destructor
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(size_t count, T const& value, Allocator const& alloc)
+    : vector(alloc) {
+    assign(count, value);
+}
+
+template <typename T, typename Allocator, typename Growth>
+template <typename InputIt, typename>
+vector<T, Allocator, Growth>::vector(InputIt first, InputIt last, Allocator const& alloc)
+    : vector(alloc) {
+    insert(end(), first, last);
+}
+
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::vector(vector<T, Allocator, Growth>&& other) noexcept
+    : alloc_(std::move(other.alloc_))
+    , data_(other.data_)
+    , size_(other.size_)
+    , capacity_(other.capacity_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.capacity_ = 0;
+}
+
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>& vector<T, Allocator, Growth>::operator=(vector<T, Allocator, Growth> const& other) {
     if (this == &other) {
         return *this;
     }
 
-    vector<T> tmp(other);
-    swap(tmp);
+    vector<T, Allocator, Growth> tmp(other, alloc_traits::propagate_on_container_copy_assignment::value ? other.alloc_ : alloc_);
+    swap_all(tmp);
     return *this;
 }
 
-template <typename T>
-vector<T>::~vector() {
+// without propagation a foreign buffer cannot be adopted, the elements are copied instead
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>& vector<T, Allocator, Growth>::operator=(vector<T, Allocator, Growth>&& other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    if (alloc_traits::propagate_on_container_move_assignment::value || alloc_ == other.alloc_) {
+        vector<T, Allocator, Growth> tmp(std::move(other));
+        if (!alloc_traits::propagate_on_container_move_assignment::value) {
+            tmp.alloc_ = alloc_;
+        }
+        swap_all(tmp);
+    } else {
+        vector<T, Allocator, Growth> tmp(other, alloc_);
+        swap_all(tmp);
+        other.clear();
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator, typename Growth>
+vector<T, Allocator, Growth>::~vector() {
     destroy_all(data_, size_);
-    operator delete(data_);
+    deallocate(data_, capacity_);
+}
+
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::allocator_type vector<T, Allocator, Growth>::get_allocator() const {
+    return alloc_;
 }
 
-template <typename T>
-T& vector<T>::operator[](size_t i) {
+template <typename T, typename Allocator, typename Growth>
+T& vector<T, Allocator, Growth>::operator[](size_t i) {
     return data_[i];
 }
 
-template <typename T>
-T const& vector<T>::operator[](size_t i) const {
+template <typename T, typename Allocator, typename Growth>
+T const& vector<T, Allocator, Growth>::operator[](size_t i) const {
     return data_[i];
 }
 
-template <typename T>
-T* vector<T>::data() {
+template <typename T, typename Allocator, typename Growth>
+T* vector<T, Allocator, Growth>::data() {
     return data_;
 }
 
-template <typename T>
-T const* vector<T>::data() const {
+template <typename T, typename Allocator, typename Growth>
+T const* vector<T, Allocator, Growth>::data() const {
     return data_;
 }
 
-template <typename T>
-size_t vector<T>::size() const {
+template <typename T, typename Allocator, typename Growth>
+size_t vector<T, Allocator, Growth>::size() const {
     return size_;
 }
 
-template <typename T>
-T& vector<T>::front() {
+template <typename T, typename Allocator, typename Growth>
+T& vector<T, Allocator, Growth>::front() {
     return *data_;
 }
 
-template <typename T>
-T const& vector<T>::front() const {
+template <typename T, typename Allocator, typename Growth>
+T const& vector<T, Allocator, Growth>::front() const {
     return *data_;
 }
 
-template <typename T>
-T& vector<T>::back() {
+template <typename T, typename Allocator, typename Growth>
+T& vector<T, Allocator, Growth>::back() {
     return data_[size_ - 1];
 }
 
-template <typename T>
-T const& vector<T>::back() const {
+template <typename T, typename Allocator, typename Growth>
+T const& vector<T, Allocator, Growth>::back() const {
     return data_[size_ - 1];
 }
 
-template <typename T>
-void vector<T>::push_back(T const& value) {
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::push_back(T const& value) {
+    emplace_back(value);
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::push_back(T&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T, typename Allocator, typename Growth>
+template <typename... Args>
+T& vector<T, Allocator, Growth>::emplace_back(Args&&... args) {
     if (size_ != capacity_) {
-        new (data_ + size_) T(value);
+        alloc_traits::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
         ++size_;
     } else {
-        push_back_realloc(value);
+        emplace_back_realloc(std::forward<Args>(args)...);
     }
+    return data_[size_ - 1];
 }
 
-template <typename T>
-void vector<T>::pop_back() {
-    data_[--size_].~T();
+// under shrinking<> this may reallocate and invalidate all iterators, not only end()
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::pop_back() {
+    alloc_traits::destroy(alloc_, data_ + --size_);
+    shrink_if_sparse();
 }
 
-template <typename T>
-bool vector<T>::empty() const {
+template <typename T, typename Allocator, typename Growth>
+bool vector<T, Allocator, Growth>::empty() const {
     return size_ == 0;
 }
 
-template <typename T>
-size_t vector<T>::capacity() const {
+template <typename T, typename Allocator, typename Growth>
+size_t vector<T, Allocator, Growth>::capacity() const {
     return capacity_;
 }
 
-template <typename T>
-void vector<T>::reserve(size_t new_capacity) {
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::reserve(size_t new_capacity) {
     if (capacity_ >= new_capacity) {
         return;
     }
     new_buffer(new_capacity);
 }
 
-template <typename T>
-void vector<T>::shrink_to_fit() {
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::shrink_to_fit() {
     if (size_ < capacity_) {
         new_buffer(size_);
     }
 }
 
-template <typename T>
-void vector<T>::clear() {
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::resize(size_t new_size) {
+    if (new_size <= size_) {
+        destroy_all(data_ + new_size, size_ - new_size);
+        size_ = new_size;
+        shrink_if_sparse();
+        return;
+    }
+    if (new_size > capacity_) {
+        new_buffer(std::max(increase_capacity(), new_size));
+    }
+
+    default_construct_all(data_ + size_, new_size - size_);
+    size_ = new_size;
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::resize(size_t new_size, T const& value) {
+    if (new_size <= size_) {
+        destroy_all(data_ + new_size, size_ - new_size);
+        size_ = new_size;
+        shrink_if_sparse();
+        return;
+    }
+    T tmp(value);
+    if (new_size > capacity_) {
+        new_buffer(std::max(increase_capacity(), new_size));
+    }
+    construct_from(data_ + size_, repeat_iterator{&tmp}, new_size - size_);
+    size_ = new_size;
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::clear() {
     destroy_all(data_, size_);
     size_ = 0;
 }
 
-template <typename T>
-void vector<T>::swap(vector& other) {
+// value may be one of the elements, the new buffer is filled before the old one goes
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::assign(size_t count, T const& value) {
+    vector<T, Allocator, Growth> tmp(alloc_);
+    tmp.data_ = allocate(count);
+    tmp.capacity_ = count;
+    construct_from(tmp.data_, repeat_iterator{&value}, count);
+    tmp.size_ = count;
+    swap_all(tmp);
+}
+
+template <typename T, typename Allocator, typename Growth>
+template <typename InputIt, typename>
+void vector<T, Allocator, Growth>::assign(InputIt first, InputIt last) {
+    vector<T, Allocator, Growth> tmp(first, last, alloc_);
+    swap_all(tmp);
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::swap(vector& other) {
+    if (alloc_traits::propagate_on_container_swap::value) {
+        std::swap(alloc_, other.alloc_);
+    }
     std::swap(data_, other.data_);
     std::swap(size_, other.size_);
     std::swap(capacity_, other.capacity_);
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::begin() {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::begin() {
     return data_;
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::end() {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::end() {
     return data_ + size_;
 }
 
-template <typename T>
-typename vector<T>::const_iterator vector<T>::begin() const {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::const_iterator vector<T, Allocator, Growth>::begin() const {
     return data_;
 }
 
-template <typename T>
-typename vector<T>::const_iterator vector<T>::end() const {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::const_iterator vector<T, Allocator, Growth>::end() const {
     return data_ + size_;
 }
 
-template <typename T>
-typename vector<T>::const_iterator vector<T>::cbegin() const {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::const_iterator vector<T, Allocator, Growth>::cbegin() const {
     return begin();
 }
 
-template <typename T>
-typename vector<T>::const_iterator vector<T>::cend() const {
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::const_iterator vector<T, Allocator, Growth>::cend() const {
     return end();
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::insert(const_iterator pos, T const& val) {
+// the arguments may refer into the vector, so the element is built before anything moves
+template <typename T, typename Allocator, typename Growth>
+template <typename... Args>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::emplace(const_iterator pos, Args&&... args) {
     size_t ind = pos - begin();
-    push_back(val);
+    if (ind == size_) {
+        emplace_back(std::forward<Args>(args)...);
+        return begin() + ind;
+    }
+    T tmp(std::forward<Args>(args)...);
+    return insert_forward(ind, std::make_move_iterator(&tmp), 1);
+}
 
-    for (size_t i = size_ - 1; i != ind; i--) {
-        std::swap(data_[i], data_[i - 1]);
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::insert(const_iterator pos, T const& val) {
+    return insert(pos, 1, val);
+}
+
+// val may live inside the vector, so it is copied before anything moves
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::insert(const_iterator pos, size_t count, T const& val) {
+    size_t ind = pos - begin();
+    if (count == 0) {
+        return begin() + ind;
     }
+    T tmp(val);
+    return insert_forward(ind, repeat_iterator{&tmp}, count);
+}
+
+template <typename T, typename Allocator, typename Growth>
+template <typename InputIt, typename>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::insert(const_iterator pos, InputIt first, InputIt last) {
+    return insert_range(pos - begin(), first, last, typename std::iterator_traits<InputIt>::iterator_category());
+}
+
+// a single pass range is buffered first, its length is needed up front
+template <typename T, typename Allocator, typename Growth>
+template <typename InputIt>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::insert_range(size_t ind, InputIt first, InputIt last,
+                                                                           std::input_iterator_tag) {
+    vector<T, Allocator, Growth> buffer(alloc_);
+    for (; first != last; ++first) {
+        buffer.push_back(*first);
+    }
+    return insert_forward(ind, std::make_move_iterator(buffer.data_), buffer.size_);
+}
 
+template <typename T, typename Allocator, typename Growth>
+template <typename ForwardIt>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::insert_range(size_t ind, ForwardIt first, ForwardIt last,
+                                                                           std::forward_iterator_tag) {
+    return insert_forward(ind, first, std::distance(first, last));
+}
+
+template <typename T, typename Allocator, typename Growth>
+template <typename ForwardIt>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::insert_forward(size_t ind, ForwardIt first, size_t count) {
+    if (count == 0) {
+        return begin() + ind;
+    }
+    if (size_ + count > capacity_) {
+        insert_realloc(ind, first, count);
+    } else {
+        insert_shift(ind, first, count, std::is_trivially_copyable<T>());
+    }
     return begin() + ind;
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::erase(const_iterator pos) {
-    return erase(pos, pos + 1);
+template <typename T, typename Allocator, typename Growth>
+template <typename ForwardIt>
+void vector<T, Allocator, Growth>::insert_shift(size_t ind, ForwardIt first, size_t count, std::true_type) {
+    std::memmove(data_ + ind + count, data_ + ind, (size_ - ind) * sizeof(T));
+    for (size_t i = 0; i < count; i++, ++first) {
+        alloc_traits::construct(alloc_, data_ + ind + i, *first);
+    }
+    size_ += count;
+}
+
+// the tail is move-constructed into the raw storage past the end and move-assigned
+// inside the initialized part, the gap is then filled by assignment
+template <typename T, typename Allocator, typename Growth>
+template <typename ForwardIt>
+void vector<T, Allocator, Growth>::insert_shift(size_t ind, ForwardIt first, size_t count, std::false_type) {
+    size_t tail = size_ - ind;
+    T* end = data_ + size_;
+    if (count <= tail) {
+        move_construct_all(end, end - count, count);
+        size_ += count;
+        std::move_backward(data_ + ind, end - count, end);
+        for (size_t i = 0; i < count; i++, ++first) {
+            data_[ind + i] = *first;
+        }
+    } else {
+        ForwardIt mid = first;
+        for (size_t i = 0; i < tail; i++) {
+            ++mid;
+        }
+        construct_from(end, mid, count - tail);
+        size_ += count - tail;
+        move_construct_all(data_ + size_, data_ + ind, tail);
+        size_ += tail;
+        for (size_t i = 0; i < tail; i++, ++first) {
+            data_[ind + i] = *first;
+        }
+    }
+}
+
+// the old buffer is left untouched until the new one is complete
+template <typename T, typename Allocator, typename Growth>
+template <typename ForwardIt>
+void vector<T, Allocator, Growth>::insert_realloc(size_t ind, ForwardIt first, size_t count) {
+    vector<T, Allocator, Growth> tmp(alloc_);
+    tmp.capacity_ = std::max(increase_capacity(), size_ + count);
+    tmp.data_ = allocate(tmp.capacity_);
+
+    construct_from(tmp.data_ + ind, first, count);
+    try {
+        move_construct_all(tmp.data_, data_, ind);
+        try {
+            move_construct_all(tmp.data_ + ind + count, data_ + ind, size_ - ind);
+        } catch (...) {
+            destroy_all(tmp.data_, ind);
+            throw;
+        }
+    } catch (...) {
+        destroy_all(tmp.data_ + ind, count);
+        throw;
+    }
+    tmp.size_ = size_ + count;
+    swap_all(tmp);
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::erase(const_iterator first, const_iterator last) {
-    ptrdiff_t shift = first - begin();
-    std::move(last, cend(), begin() + shift);
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::erase(const_iterator pos) {
+    return erase(pos, pos + 1);
+}
 
-    ptrdiff_t diff = last - first;
-    while (diff > 0) {
-        pop_back();
-        diff--;
+template <typename T, typename Allocator, typename Growth>
+typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::erase(const_iterator first, const_iterator last) {
+    size_t ind = first - begin();
+    size_t count = last - first;
+    if (count != 0) {
+        erase_shift(ind, count, std::is_trivially_copyable<T>());
+        shrink_if_sparse();
     }
+    return begin() + ind;
+}
 
-    return begin() + shift;
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::erase_shift(size_t ind, size_t count, std::true_type) {
+    std::memmove(data_ + ind, data_ + ind + count, (size_ - ind - count) * sizeof(T));
+    size_ -= count;
 }
 
-template <typename T>
-size_t vector<T>::increase_capacity() const {
-    return capacity_ == 0 ? 1 : capacity_ * 2;
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::erase_shift(size_t ind, size_t count, std::false_type) {
+    std::move(data_ + ind + count, data_ + size_, data_ + ind);
+    destroy_all(data_ + size_ - count, count);
+    size_ -= count;
 }
 
-template <typename T>
-void vector<T>::push_back_realloc(T const& value) {
-    T tmp(value);
-    new_buffer(increase_capacity());
-    new (data_ + size_) T(tmp);
-    ++size_;
+template <typename T, typename Allocator, typename Growth>
+size_t vector<T, Allocator, Growth>::increase_capacity() const {
+    return Growth::next_capacity(capacity_, sizeof(T));
 }
 
-template <typename T>
-void vector<T>::new_buffer(size_t new_capacity) {
-    vector<T> tmp;
+// only when relocation cannot throw, a failed allocation just keeps the old buffer
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::shrink_if_sparse() {
+    if (!Growth::auto_shrink || size_ >= capacity_ / 4
+        || !(std::is_trivially_copyable<T>::value || std::is_nothrow_move_constructible<T>::value)) {
+        return;
+    }
+    size_t new_capacity = capacity_ / 2;
+    while (size_ < new_capacity / 4) {
+        new_capacity /= 2;
+    }
+    try {
+        new_buffer(new_capacity);
+    } catch (...) {
+    }
+}
+// the new element is built first, its arguments may refer to the elements being relocated
+template <typename T, typename Allocator, typename Growth>
+template <typename... Args>
+void vector<T, Allocator, Growth>::emplace_back_realloc(Args&&... args) {
+    vector<T, Allocator, Growth> tmp(alloc_);
+    tmp.capacity_ = increase_capacity();
+    tmp.data_ = allocate(tmp.capacity_);
+
+    alloc_traits::construct(alloc_, tmp.data_ + size_, std::forward<Args>(args)...);
+    try {
+        relocate_all(tmp.data_, data_, size_);
+    } catch (...) {
+        alloc_traits::destroy(alloc_, tmp.data_ + size_);
+        throw;
+    }
+    tmp.size_ = size_ + 1;
+    size_ = 0;
+    swap_all(tmp);
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::new_buffer(size_t new_capacity) {
+    vector<T, Allocator, Growth> tmp(alloc_);
     if (new_capacity != 0) {
         tmp.data_ = allocate(new_capacity);
-        copy_construct_all(tmp.data_, data_, size_);
         tmp.capacity_ = new_capacity;
+        relocate_all(tmp.data_, data_, size_);
         tmp.size_ = size_;
+        size_ = 0;
     }
-    swap(tmp);
+    swap_all(tmp);
+}
+
+// swaps the allocators regardless of propagate_on_container_swap, the buffers follow them
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::swap_all(vector& other) {
+    std::swap(alloc_, other.alloc_);
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
 }
 
-template <typename T>
-void vector<T>::destroy_all(T* vec, size_t size) {
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::destroy_all(T* vec, size_t size) {
     while (size > 0) {
         size--;
-        vec[size].~T();
+        alloc_traits::destroy(alloc_, vec + size);
     }
 }
 
-template <typename T>
-void vector<T>::copy_construct_all(T* dst, T const* src, size_t size) {
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::copy_construct_all(T* dst, T const* src, size_t size) {
+    copy_construct_all(dst, src, size, std::is_trivially_copyable<T>());
+}
+
+// trivially copyable elements cannot throw while being copied
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::copy_construct_all(T* dst, T const* src, size_t size, std::true_type) {
+    parallel_slices(size, sizeof(T), [=](size_t first, size_t last) {
+        if (first != last) {
+            std::memcpy(dst + first, src + first, (last - first) * sizeof(T));
+        }
+    }, [](size_t, size_t) {});
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::copy_construct_all(T* dst, T const* src, size_t size, std::false_type) {
     size_t i = 0;
 
     try {
         for (; i < size; i++) {
-            new (dst + i) T(src[i]);
+            alloc_traits::construct(alloc_, dst + i, src[i]);
         }
     } catch (...) {
         destroy_all(dst, i);
@@ -316,9 +838,129 @@ void vector<T>::copy_construct_all(T* dst, T const* src, size_t size) {
     }
 }
 
-template <typename T>
-T* vector<T>::allocate(size_t size) {
-    return size == 0 ? nullptr : static_cast<T*>(operator new(size * sizeof(T)));
+// constructs dst from src and destroys src; moves only when that cannot throw,
+// so src stays intact if a copy throws
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::relocate_all(T* dst, T* src, size_t size) {
+    relocate_all(dst, src, size, std::integral_constant<bool, !std::is_trivially_copyable<T>::value
+                                                              && std::is_nothrow_move_constructible<T>::value>());
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::relocate_all(T* dst, T* src, size_t size, std::true_type) {
+    for (size_t i = 0; i < size; i++) {
+        alloc_traits::construct(alloc_, dst + i, std::move(src[i]));
+        alloc_traits::destroy(alloc_, src + i);
+    }
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::relocate_all(T* dst, T* src, size_t size, std::false_type) {
+    copy_construct_all(dst, src, size);
+    destroy_all(src, size);
+}
+
+// moves when that cannot throw, src stays intact if a copy throws
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::move_construct_all(T* dst, T* src, size_t size) {
+    move_construct_all(dst, src, size, std::is_trivially_copyable<T>());
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::move_construct_all(T* dst, T* src, size_t size, std::true_type) {
+    if (size != 0) {
+        std::memcpy(dst, src, size * sizeof(T));
+    }
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::move_construct_all(T* dst, T* src, size_t size, std::false_type) {
+    size_t i = 0;
+
+    try {
+        for (; i < size; i++) {
+            alloc_traits::construct(alloc_, dst + i, std::move_if_noexcept(src[i]));
+        }
+    } catch (...) {
+        destroy_all(dst, i);
+        throw;
+    }
+}
+
+// value-initializing a trivial type zeroes it
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::default_construct_all(T* dst, size_t size) {
+    default_construct_all(dst, size, std::is_trivial<T>());
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::default_construct_all(T* dst, size_t size, std::true_type) {
+    parallel_slices(size, sizeof(T), [=](size_t first, size_t last) {
+        if (first != last) {
+            std::memset(static_cast<void*>(dst + first), 0, (last - first) * sizeof(T));
+        }
+    }, [](size_t, size_t) {});
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::default_construct_all(T* dst, size_t size, std::false_type) {
+    size_t i = 0;
+
+    try {
+        for (; i < size; i++) {
+            alloc_traits::construct(alloc_, dst + i);
+        }
+    } catch (...) {
+        destroy_all(dst, i);
+        throw;
+    }
+}
+
+// only trivially copyable elements read through a pointer or repeat_iterator are copied in
+// parallel, a user iterator may not be safe to dereference from several threads
+template <typename T, typename Allocator, typename Growth>
+template <typename ForwardIt>
+void vector<T, Allocator, Growth>::construct_from(T* dst, ForwardIt first, size_t count) {
+    construct_from(dst, first, count, std::integral_constant<bool, std::is_trivially_copyable<T>::value
+        && (std::is_same<ForwardIt, T*>::value || std::is_same<ForwardIt, T const*>::value
+            || std::is_same<ForwardIt, repeat_iterator>::value)>());
+}
+
+template <typename T, typename Allocator, typename Growth>
+template <typename ForwardIt>
+void vector<T, Allocator, Growth>::construct_from(T* dst, ForwardIt first, size_t count, std::true_type) {
+    parallel_slices(count, sizeof(T), [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            std::memcpy(static_cast<void*>(dst + i), &*(first + i), sizeof(T));
+        }
+    }, [](size_t, size_t) {});
+}
+
+template <typename T, typename Allocator, typename Growth>
+template <typename ForwardIt>
+void vector<T, Allocator, Growth>::construct_from(T* dst, ForwardIt first, size_t count, std::false_type) {
+    size_t i = 0;
+
+    try {
+        for (; i < count; i++, ++first) {
+            alloc_traits::construct(alloc_, dst + i, *first);
+        }
+    } catch (...) {
+        destroy_all(dst, i);
+        throw;
+    }
+}
+
+template <typename T, typename Allocator, typename Growth>
+T* vector<T, Allocator, Growth>::allocate(size_t size) {
+    return size == 0 ? nullptr : alloc_traits::allocate(alloc_, size);
+}
+
+template <typename T, typename Allocator, typename Growth>
+void vector<T, Allocator, Growth>::deallocate(T* ptr, size_t size) {
+    if (ptr != nullptr) {
+        alloc_traits::deallocate(alloc_, ptr, size);
+    }
 }
 
 #endif // VECTOR_H